@@ -0,0 +1,275 @@
+#include "attacks.h"
+
+#include "board.h"
+#include "move.h"
+
+namespace Chess
+{
+    namespace
+    {
+        constexpr int SQUARE_COUNT = BOARD_SIZE * BOARD_SIZE;
+
+        using Table = std::array<Bitboard, SQUARE_COUNT>;
+
+        // The first four directions increase the square index, the last four decrease it.
+        constexpr int DIRECTION_COUNT = 8;
+        constexpr int DIRECTIONS[DIRECTION_COUNT][2] = {
+            {0, 1}, {1, 0}, {1, 1}, {-1, 1},
+            {0, -1}, {-1, 0}, {-1, -1}, {1, -1}};
+
+        constexpr Bitboard bitAt(int x, int y)
+        {
+            if (x < 0 || x >= BOARD_SIZE || y < 0 || y >= BOARD_SIZE) return 0;
+            return (Bitboard)1 << (y * BOARD_SIZE + x);
+        }
+
+        constexpr Table makeJumpTable(const int (&offsets)[8][2])
+        {
+            Table table{};
+
+            for (int square = 0; square < SQUARE_COUNT; square++)
+            {
+                for (const auto &offset : offsets)
+                {
+                    table[square] |= bitAt(square % BOARD_SIZE + offset[0], square / BOARD_SIZE + offset[1]);
+                }
+            }
+
+            return table;
+        }
+
+        constexpr std::array<Table, 2> makePawnTables()
+        {
+            std::array<Table, 2> tables{};
+
+            for (int square = 0; square < SQUARE_COUNT; square++)
+            {
+                int x = square % BOARD_SIZE;
+                int y = square / BOARD_SIZE;
+
+                tables[(int)Color::White][square] = bitAt(x - 1, y + 1) | bitAt(x + 1, y + 1);
+                tables[(int)Color::Black][square] = bitAt(x - 1, y - 1) | bitAt(x + 1, y - 1);
+            }
+
+            return tables;
+        }
+
+        // Every square reachable from a square in a direction on an empty board.
+        constexpr std::array<Table, DIRECTION_COUNT> makeRayTables()
+        {
+            std::array<Table, DIRECTION_COUNT> tables{};
+
+            for (int direction = 0; direction < DIRECTION_COUNT; direction++)
+            {
+                for (int square = 0; square < SQUARE_COUNT; square++)
+                {
+                    int x = square % BOARD_SIZE + DIRECTIONS[direction][0];
+                    int y = square / BOARD_SIZE + DIRECTIONS[direction][1];
+
+                    while (bitAt(x, y) != 0)
+                    {
+                        tables[direction][square] |= bitAt(x, y);
+                        x += DIRECTIONS[direction][0];
+                        y += DIRECTIONS[direction][1];
+                    }
+                }
+            }
+
+            return tables;
+        }
+
+        constexpr int KNIGHT_OFFSETS[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+        constexpr int KING_OFFSETS[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+
+        constexpr Table KNIGHT_ATTACKS = makeJumpTable(KNIGHT_OFFSETS);
+        constexpr Table KING_ATTACKS = makeJumpTable(KING_OFFSETS);
+        constexpr std::array<Table, 2> PAWN_ATTACKS = makePawnTables();
+        constexpr std::array<Table, DIRECTION_COUNT> RAYS = makeRayTables();
+
+        Bitboard slide(int square, Bitboard occupancy, int direction)
+        {
+            Bitboard ray = RAYS[direction][square];
+            Bitboard blockers = ray & occupancy;
+
+            if (blockers == 0) return ray;
+
+            // the nearest blocker is the lowest bit on increasing rays and the highest on decreasing ones
+            int blocker = direction < DIRECTION_COUNT / 2 ? __builtin_ctzll(blockers) : 63 - __builtin_clzll(blockers);
+
+            return ray ^ RAYS[direction][blocker];
+        }
+    }
+
+    namespace Attacks
+    {
+        Bitboard knight(int square)
+        {
+            return KNIGHT_ATTACKS[square];
+        }
+
+        Bitboard king(int square)
+        {
+            return KING_ATTACKS[square];
+        }
+
+        Bitboard pawn(Color color, int square)
+        {
+            return PAWN_ATTACKS[(int)color][square];
+        }
+
+        Bitboard bishop(int square, Bitboard occupancy)
+        {
+            return slide(square, occupancy, 2) | slide(square, occupancy, 3) | slide(square, occupancy, 6) | slide(square, occupancy, 7);
+        }
+
+        Bitboard rook(int square, Bitboard occupancy)
+        {
+            return slide(square, occupancy, 0) | slide(square, occupancy, 1) | slide(square, occupancy, 4) | slide(square, occupancy, 5);
+        }
+
+        Bitboard queen(int square, Bitboard occupancy)
+        {
+            return bishop(square, occupancy) | rook(square, occupancy);
+        }
+
+        Bitboard of(PieceType type, Color color, int square, Bitboard occupancy)
+        {
+            switch (type)
+            {
+            case PieceType::King:
+                return king(square);
+            case PieceType::Queen:
+                return queen(square, occupancy);
+            case PieceType::Rook:
+                return rook(square, occupancy);
+            case PieceType::Bishop:
+                return bishop(square, occupancy);
+            case PieceType::Knight:
+                return knight(square);
+            case PieceType::Pawn:
+                return pawn(color, square);
+            }
+
+            return 0;
+        }
+
+        int lsb(Bitboard bitboard)
+        {
+            return __builtin_ctzll(bitboard);
+        }
+
+        int popLsb(Bitboard &bitboard)
+        {
+            int square = __builtin_ctzll(bitboard);
+            bitboard &= bitboard - 1;
+            return square;
+        }
+
+        int count(Bitboard bitboard)
+        {
+            return __builtin_popcountll(bitboard);
+        }
+    }
+
+    AttackMap::AttackMap()
+        : m_attacksFrom{}, m_owner{}, m_counts{}, m_attacked{}
+    {
+    }
+
+    void AttackMap::removeSource(int square)
+    {
+        Bitboard attacks = m_attacksFrom[square];
+        int owner = m_owner[square];
+
+        while (attacks != 0)
+        {
+            int target = Attacks::popLsb(attacks);
+
+            if (--m_counts[owner][target] == 0)
+                m_attacked[owner] &= ~((Bitboard)1 << target);
+        }
+
+        m_attacksFrom[square] = 0;
+    }
+
+    void AttackMap::addSource(const Board &board, int square)
+    {
+        const Piece *piece = board.getSquare(Vector2::fromIndex(square)).getPiece();
+
+        if (piece == nullptr) return;
+
+        Bitboard attacks = Attacks::of(piece->getType(), piece->getColor(), square, board.getOccupancy());
+        int owner = (int)piece->getColor();
+
+        m_attacksFrom[square] = attacks;
+        m_owner[square] = owner;
+        m_attacked[owner] |= attacks;
+
+        while (attacks != 0)
+        {
+            m_counts[owner][Attacks::popLsb(attacks)]++;
+        }
+    }
+
+    void AttackMap::compute(const Board &board)
+    {
+        *this = AttackMap();
+
+        Bitboard occupied = board.getOccupancy();
+
+        while (occupied != 0)
+        {
+            addSource(board, Attacks::popLsb(occupied));
+        }
+    }
+
+    void AttackMap::update(const Board &board, const Move &move)
+    {
+        update(board, ((Bitboard)1 << move.m_from.toIndex()) | ((Bitboard)1 << move.m_to.toIndex()));
+    }
+
+    void AttackMap::update(const Board &board, Bitboard changedSquares)
+    {
+        Bitboard occupancy = board.getOccupancy();
+        Bitboard diagonal = board.getPieces(PieceType::Bishop) | board.getPieces(PieceType::Queen);
+        Bitboard straight = board.getPieces(PieceType::Rook) | board.getPieces(PieceType::Queen);
+
+        // A slider's attacks only change if its ray reaches one of the changed squares,
+        // and in that case it still reaches it on the updated board.
+        Bitboard sources = changedSquares;
+        Bitboard changed = changedSquares;
+
+        while (changed != 0)
+        {
+            int square = Attacks::popLsb(changed);
+            sources |= (Attacks::bishop(square, occupancy) & diagonal) | (Attacks::rook(square, occupancy) & straight);
+        }
+
+        Bitboard toRemove = sources;
+
+        while (toRemove != 0)
+        {
+            removeSource(Attacks::popLsb(toRemove));
+        }
+
+        while (sources != 0)
+        {
+            addSource(board, Attacks::popLsb(sources));
+        }
+    }
+
+    Bitboard AttackMap::getAttackedBy(Color color) const
+    {
+        return m_attacked[(int)color];
+    }
+
+    int AttackMap::getAttackerCount(Vector2 square, Color color) const
+    {
+        return m_counts[(int)color][square.toIndex()];
+    }
+
+    bool AttackMap::isAttacked(Vector2 square, Color byColor) const
+    {
+        return (m_attacked[(int)byColor] >> square.toIndex()) & 1;
+    }
+}
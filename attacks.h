@@ -0,0 +1,61 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "primitives.h"
+
+#include <array>
+
+namespace Chess
+{
+    class Board;
+    class Move;
+
+    // Precomputed attack tables, squares are indexed as in Vector2::toIndex().
+    namespace Attacks
+    {
+        Bitboard knight(int square);
+        Bitboard king(int square);
+        // Squares a pawn of the given color standing on square attacks.
+        Bitboard pawn(Color color, int square);
+
+        Bitboard bishop(int square, Bitboard occupancy);
+        Bitboard rook(int square, Bitboard occupancy);
+        Bitboard queen(int square, Bitboard occupancy);
+
+        // Attacks of the given piece standing on square.
+        Bitboard of(PieceType type, Color color, int square, Bitboard occupancy);
+
+        int lsb(Bitboard bitboard);
+        int popLsb(Bitboard &bitboard);
+        int count(Bitboard bitboard);
+    }
+
+    // Per side attack counts for every square, kept up to date move by move
+    // instead of being recomputed from scratch.
+    class AttackMap
+    {
+        std::array<Bitboard, BOARD_SIZE * BOARD_SIZE> m_attacksFrom;
+        std::array<uint8_t, BOARD_SIZE * BOARD_SIZE> m_owner;
+        std::array<std::array<uint8_t, BOARD_SIZE * BOARD_SIZE>, 2> m_counts;
+        std::array<Bitboard, 2> m_attacked;
+
+        void removeSource(int square);
+        void addSource(const Board &board, int square);
+
+    public:
+        AttackMap();
+
+        void compute(const Board &board);
+
+        // Call with the board after (or after undoing) the move.
+        void update(const Board &board, const Move &move);
+        // Refreshes every attack that could have changed because the occupancy of changedSquares did.
+        void update(const Board &board, Bitboard changedSquares);
+
+        Bitboard getAttackedBy(Color color) const;
+        int getAttackerCount(Vector2 square, Color color) const;
+        bool isAttacked(Vector2 square, Color byColor) const;
+    };
+}
+
+#endif
@@ -1,77 +1,126 @@
 #include "board.h"
 
-#include <iostream>
+#include "attacks.h"
+
+#include <algorithm>
 
 namespace Chess
 {
-    Board::Board()
+    namespace
     {
-        for (int i = 0; i < BOARD_SIZE; i++)
+        // Indexed by piece code and square, code 0 (empty) hashes to 0.
+        using ZobristTable = std::array<std::array<uint64_t, BOARD_SIZE * BOARD_SIZE>, 1 + 2 * PIECE_TYPE_COUNT>;
+
+        constexpr ZobristTable makeZobristTable()
         {
-            m_squares.push_back(std::vector<std::shared_ptr<Square>>());
+            ZobristTable table{};
+            uint64_t state = 0;
 
-            for (int j = 0; j < BOARD_SIZE; j++)
+            for (int code = 1; code <= 2 * PIECE_TYPE_COUNT; code++)
             {
-                m_squares[i].push_back(std::make_shared<Square>());
+                for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++)
+                {
+                    table[code][square] = splitMix(state);
+                }
             }
+
+            return table;
         }
+
+        constexpr ZobristTable ZOBRIST = makeZobristTable();
+    }
+
+    Board::Board()
+        : m_colors{}, m_types{}, m_hash(0)
+    {
     }
 
     bool Board::initDefault()
     {
-        // WHITE
-        m_squares[0][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[1][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[2][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[3][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[4][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[5][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[6][1]->setPiece(std::make_shared<Pawn>(Color::White));
-        m_squares[7][1]->setPiece(std::make_shared<Pawn>(Color::White));
-
-        m_squares[0][0]->setPiece(std::make_shared<Rook>(Color::White));
-        m_squares[1][0]->setPiece(std::make_shared<Knight>(Color::White));
-        m_squares[2][0]->setPiece(std::make_shared<Bishop>(Color::White));
-        m_squares[3][0]->setPiece(std::make_shared<Queen>(Color::White));
-        m_squares[4][0]->setPiece(std::make_shared<King>(Color::White));
-        m_squares[5][0]->setPiece(std::make_shared<Bishop>(Color::White));
-        m_squares[6][0]->setPiece(std::make_shared<Knight>(Color::White));
-        m_squares[7][0]->setPiece(std::make_shared<Rook>(Color::White));
-
-        // BLACK
-        m_squares[0][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[1][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[2][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[3][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[4][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[5][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[6][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-        m_squares[7][6]->setPiece(std::make_shared<Pawn>(Color::Black));
-
-        m_squares[0][7]->setPiece(std::make_shared<Rook>(Color::Black));
-        m_squares[1][7]->setPiece(std::make_shared<Knight>(Color::Black));
-        m_squares[2][7]->setPiece(std::make_shared<Bishop>(Color::Black));
-        m_squares[3][7]->setPiece(std::make_shared<Queen>(Color::Black));
-        m_squares[4][7]->setPiece(std::make_shared<King>(Color::Black));
-        m_squares[5][7]->setPiece(std::make_shared<Bishop>(Color::Black));
-        m_squares[6][7]->setPiece(std::make_shared<Knight>(Color::Black));
-        m_squares[7][7]->setPiece(std::make_shared<Rook>(Color::Black));
+        const PieceType backRank[BOARD_SIZE] = {
+            PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+            PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook};
+
+        *this = Board();
+
+        for (int x = 0; x < BOARD_SIZE; x++)
+        {
+            // WHITE
+            setPiece(Vector2(x, 0), Piece::get(backRank[x], Color::White));
+            setPiece(Vector2(x, 1), Piece::get(PieceType::Pawn, Color::White));
+
+            // BLACK
+            setPiece(Vector2(x, 6), Piece::get(PieceType::Pawn, Color::Black));
+            setPiece(Vector2(x, 7), Piece::get(backRank[x], Color::Black));
+        }
+
         return true;
     }
 
-    std::vector<std::vector<std::shared_ptr<Square>>> Board::getSquares()
+    const Square &Board::getSquare(Vector2 position) const
     {
-        return m_squares;
+        return m_squares[position.toIndex()];
     }
 
-    std::shared_ptr<Square> Board::getSquare(Vector2 position)
+    bool Board::setPiece(Vector2 position, const Piece *piece)
     {
-        return m_squares[position.m_x][position.m_y];
+        int index = position.toIndex();
+        Bitboard bit = (Bitboard)1 << index;
+        const Piece *previous = m_squares[index].getPiece();
+
+        if (previous != nullptr)
+        {
+            m_colors[(int)previous->getColor()] &= ~bit;
+            m_types[(int)previous->getType()] &= ~bit;
+            m_hash ^= ZOBRIST[previous->getCode()][index];
+        }
+
+        if (piece != nullptr)
+        {
+            m_colors[(int)piece->getColor()] |= bit;
+            m_types[(int)piece->getType()] |= bit;
+            m_hash ^= ZOBRIST[piece->getCode()][index];
+        }
+
+        return m_squares[index].setPiece(piece);
     }
 
-    bool Board::isPositionInBounds(Vector2 position)
+    bool Board::setPieceCodes(const uint8_t *codes)
     {
-        if (position.m_x < 0 || (size_t)position.m_x >= m_squares.size() || position.m_y < 0 || (size_t)position.m_y >= m_squares.size())
+        // accumulated in locals, the byte stores into m_squares would otherwise force every update through memory
+        std::array<Bitboard, 2> colors{};
+        std::array<Bitboard, PIECE_TYPE_COUNT> types{};
+        uint64_t hash = 0;
+
+        // branch free on the code layout of Piece::getCode(), 1 + type, plus PIECE_TYPE_COUNT for black
+        for (int index = 0; index < BOARD_SIZE * BOARD_SIZE; index++)
+        {
+            uint8_t code = codes[index];
+            Bitboard bit = (Bitboard)(code != 0) << index;
+
+            m_squares[index].setCode(code);
+            colors[code > PIECE_TYPE_COUNT] |= bit;
+            types[(code + PIECE_TYPE_COUNT - 1) % PIECE_TYPE_COUNT] |= bit;
+        }
+
+        Bitboard occupied = colors[0] | colors[1];
+
+        while (occupied != 0)
+        {
+            int index = Attacks::popLsb(occupied);
+            hash ^= ZOBRIST[codes[index]][index];
+        }
+
+        m_colors = colors;
+        m_types = types;
+        m_hash = hash;
+
+        return true;
+    }
+
+    bool Board::isPositionInBounds(Vector2 position) const
+    {
+        if (position.m_x < 0 || position.m_x >= BOARD_SIZE || position.m_y < 0 || position.m_y >= BOARD_SIZE)
         {
             return false;
         }
@@ -79,27 +128,273 @@ namespace Chess
         return true;
     }
 
-    std::list<Move> Board::getAvailableMovesFor(Color color)
+    uint64_t Board::getHash() const
+    {
+        return m_hash;
+    }
+
+    Bitboard Board::getOccupancy() const
+    {
+        return m_colors[0] | m_colors[1];
+    }
+
+    Bitboard Board::getPieces(Color color) const
+    {
+        return m_colors[(int)color];
+    }
+
+    Bitboard Board::getPieces(PieceType type) const
+    {
+        return m_types[(int)type];
+    }
+
+    Bitboard Board::getPieces(PieceType type, Color color) const
     {
-        std::list<Move> allMoves = std::list<Move>();
+        return m_types[(int)type] & m_colors[(int)color];
+    }
+
+    Bitboard Board::attackersTo(Vector2 square, Bitboard occupancy) const
+    {
+        int index = square.toIndex();
+
+        // a piece attacks the square exactly when the same piece standing on the square would attack it
+        Bitboard diagonal = m_types[(int)PieceType::Bishop] | m_types[(int)PieceType::Queen];
+        Bitboard straight = m_types[(int)PieceType::Rook] | m_types[(int)PieceType::Queen];
 
-        for (size_t x = 0; x < m_squares.size(); x++)
+        Bitboard attackers = (Attacks::pawn(Color::White, index) & getPieces(PieceType::Pawn, Color::Black)) |
+                             (Attacks::pawn(Color::Black, index) & getPieces(PieceType::Pawn, Color::White)) |
+                             (Attacks::knight(index) & m_types[(int)PieceType::Knight]) |
+                             (Attacks::king(index) & m_types[(int)PieceType::King]) |
+                             (Attacks::bishop(index, occupancy) & diagonal) |
+                             (Attacks::rook(index, occupancy) & straight);
+
+        return attackers & occupancy;
+    }
+
+    bool Board::isSquareAttacked(Vector2 square, Color byColor) const
+    {
+        return (attackersTo(square, getOccupancy()) & m_colors[(int)byColor]) != 0;
+    }
+
+    bool Board::isInCheck(Color color) const
+    {
+        Bitboard king = getPieces(PieceType::King, color);
+
+        if (king == 0) return false;
+
+        Color opponent = color == Color::White ? Color::Black : Color::White;
+
+        return isSquareAttacked(Vector2::fromIndex(Attacks::lsb(king)), opponent);
+    }
+
+    MoveList Board::getAvailableMovesFor(Color color) const
+    {
+        MoveList allMoves;
+
+        for (int x = 0; x < BOARD_SIZE; x++)
         {
-            for (size_t y = 0; y < m_squares[0].size(); y++)
+            for (int y = 0; y < BOARD_SIZE; y++)
             {
-                auto piece = m_squares[x][y]->getPiece();
+                const Piece *piece = getSquare(Vector2(x, y)).getPiece();
 
                 if (piece == nullptr || piece->getColor() != color)
                 {
                     continue;
                 }
 
-                std::list<Move> movesForPiece = piece->getAvailableMoves(Vector2(x, y), (*this));
-
-                allMoves.splice(allMoves.end(), movesForPiece);
+                piece->getAvailableMoves(Vector2(x, y), (*this), allMoves);
             }
         }
 
         return allMoves;
     }
+
+    MoveList Board::getLegalMovesFor(Color color) const
+    {
+        MoveList availableMoves = getAvailableMovesFor(color);
+        MoveList legalMoves;
+
+        for (const Move &move : availableMoves)
+        {
+            Board after = *this;
+            Move played = move;
+            after.makeMove(played);
+
+            if (!after.isInCheck(color))
+            {
+                legalMoves.add(move);
+            }
+        }
+
+        return legalMoves;
+    }
+
+    bool Board::isLegal(const Move &move, Color color) const
+    {
+        if (!isPositionInBounds(move.m_from) || !isPositionInBounds(move.m_to))
+            return false;
+
+        const Piece *piece = getSquare(move.m_from).getPiece();
+
+        if (piece == nullptr || piece->getColor() != color)
+            return false;
+
+        MoveList pieceMoves;
+        piece->getAvailableMoves(move.m_from, *this, pieceMoves);
+
+        for (const Move &pieceMove : pieceMoves)
+        {
+            if (pieceMove == move)
+            {
+                Board after = *this;
+                Move played = move;
+                after.makeMove(played);
+
+                return !after.isInCheck(color);
+            }
+        }
+
+        return false;
+    }
+
+    MoveList Board::getCapturesFor(Color color) const
+    {
+        MoveList captures;
+
+        Color opponent = color == Color::White ? Color::Black : Color::White;
+        Bitboard occupancy = getOccupancy();
+        Bitboard targets = m_colors[(int)opponent];
+        Bitboard pieces = m_colors[(int)color];
+        int lastRow = color == Color::White ? BOARD_SIZE - 1 : 0;
+
+        while (pieces != 0)
+        {
+            int from = Attacks::popLsb(pieces);
+            const Piece *piece = m_squares[from].getPiece();
+            Bitboard attacks = Attacks::of(piece->getType(), color, from, occupancy) & targets;
+
+            while (attacks != 0)
+            {
+                Vector2 to = Vector2::fromIndex(Attacks::popLsb(attacks));
+
+                if (piece->getType() == PieceType::Pawn && to.m_y == lastRow)
+                {
+                    captures.add(Move(Vector2::fromIndex(from), to, Piece::get(PieceType::Queen, color)));
+                    captures.add(Move(Vector2::fromIndex(from), to, Piece::get(PieceType::Rook, color)));
+                    captures.add(Move(Vector2::fromIndex(from), to, Piece::get(PieceType::Bishop, color)));
+                    captures.add(Move(Vector2::fromIndex(from), to, Piece::get(PieceType::Knight, color)));
+                    continue;
+                }
+
+                captures.add(Move(Vector2::fromIndex(from), to));
+            }
+        }
+
+        return captures;
+    }
+
+    int Board::staticExchange(const Move &move) const
+    {
+        // The swap algorithm: gains[i] is the balance if the exchange stopped after the i-th capture.
+        int gains[32];
+        int depth = 0;
+
+        int to = move.m_to.toIndex();
+        const Piece *attacker = getSquare(move.m_from).getPiece();
+        const Piece *captured = getSquare(move.m_to).getPiece();
+
+        Bitboard occupancy = getOccupancy() ^ ((Bitboard)1 << move.m_from.toIndex());
+        Bitboard diagonal = m_types[(int)PieceType::Bishop] | m_types[(int)PieceType::Queen];
+        Bitboard straight = m_types[(int)PieceType::Rook] | m_types[(int)PieceType::Queen];
+        Bitboard attackers = attackersTo(move.m_to, occupancy);
+
+        gains[0] = captured != nullptr ? PIECE_VALUES[(int)captured->getType()] : 0;
+        int onSquare = PIECE_VALUES[(int)attacker->getType()];
+
+        if (move.m_promotion != nullptr)
+        {
+            onSquare = PIECE_VALUES[(int)move.m_promotion->getType()];
+            gains[0] += onSquare - PIECE_VALUES[(int)PieceType::Pawn];
+        }
+
+        Color side = attacker->getColor();
+
+        while (true)
+        {
+            side = side == Color::White ? Color::Black : Color::White;
+            Bitboard sideAttackers = attackers & m_colors[(int)side];
+
+            if (sideAttackers == 0 || depth + 1 >= 32) break;
+
+            // least valuable attacker first, PieceType is ordered from the most valuable
+            int type = PIECE_TYPE_COUNT - 1;
+            while ((sideAttackers & m_types[type]) == 0) type--;
+
+            depth++;
+            gains[depth] = onSquare - gains[depth - 1];
+
+            Bitboard bit = sideAttackers & m_types[type];
+            occupancy ^= bit & (~bit + 1);
+            onSquare = PIECE_VALUES[type];
+
+            // removing the attacker may uncover a slider behind it
+            attackers |= (Attacks::bishop(to, occupancy) & diagonal) | (Attacks::rook(to, occupancy) & straight);
+            attackers &= occupancy;
+        }
+
+        // either side may stop capturing when continuing would lose material
+        while (depth > 0)
+        {
+            gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+            depth--;
+        }
+
+        return gains[0];
+    }
+
+    bool Board::makeMove(Move &move)
+    {
+        const Piece *piece = getSquare(move.m_from).getPiece();
+
+        move.m_captured = getSquare(move.m_to).getPiece();
+        setPiece(move.m_to, move.m_promotion != nullptr ? move.m_promotion : piece);
+        setPiece(move.m_from, nullptr);
+
+        return true;
+    }
+
+    std::string Board::toFen(Color toMove, int halfmoveClock, int fullmoveNumber) const
+    {
+        std::string fen;
+
+        for (int y = BOARD_SIZE - 1; y >= 0; y--)
+        {
+            int empty = 0;
+
+            for (int x = 0; x < BOARD_SIZE; x++)
+            {
+                const Piece *piece = getSquare(Vector2(x, y)).getPiece();
+
+                if (piece == nullptr)
+                {
+                    empty++;
+                    continue;
+                }
+
+                if (empty != 0) fen += (char)('0' + empty);
+                empty = 0;
+
+                char letter = piece->getAsciiRepresentation();
+                fen += piece->getColor() == Color::White ? letter : (char)(letter - 'A' + 'a');
+            }
+
+            if (empty != 0) fen += (char)('0' + empty);
+            if (y != 0) fen += '/';
+        }
+
+        fen += toMove == Color::White ? " w" : " b";
+        fen += " - - " + std::to_string(halfmoveClock) + " " + std::to_string(fullmoveNumber);
+
+        return fen;
+    }
 }
\ No newline at end of file
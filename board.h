@@ -5,27 +5,61 @@
 #include "pieces.h"
 #include "move.h"
 
-#include <vector>
-#include <memory>
-#include <list>
+#include <array>
+#include <string>
 
 namespace Chess
 {
-    constexpr int BOARD_SIZE = 8;
-
     class Board
     {
-        std::vector<std::vector<std::shared_ptr<Square>>> m_squares;
+        std::array<Square, BOARD_SIZE * BOARD_SIZE> m_squares;
+
+        // kept in sync with m_squares by setPiece()
+        std::array<Bitboard, 2> m_colors;
+        std::array<Bitboard, PIECE_TYPE_COUNT> m_types;
+        // Zobrist hash of the pieces, also kept in sync by setPiece()
+        uint64_t m_hash;
 
     public:
         Board();
         bool initDefault();
-        std::vector<std::vector<std::shared_ptr<Square>>> getSquares();
-        std::shared_ptr<Square> getSquare(Vector2 position);
+        const Square &getSquare(Vector2 position) const;
+        bool setPiece(Vector2 position, const Piece *piece);
+        // Replaces the whole position, codes are Piece::getCode() values indexed as in Vector2::toIndex().
+        bool setPieceCodes(const uint8_t *codes);
+
+        bool isPositionInBounds(Vector2 position) const;
+
+        // Identifies the placement of the pieces, the side to move is not part of it.
+        uint64_t getHash() const;
+
+        Bitboard getOccupancy() const;
+        Bitboard getPieces(Color color) const;
+        Bitboard getPieces(PieceType type) const;
+        Bitboard getPieces(PieceType type, Color color) const;
+
+        // Pieces of both colors attacking the square, as if only the squares in occupancy were occupied.
+        Bitboard attackersTo(Vector2 square, Bitboard occupancy) const;
+        bool isSquareAttacked(Vector2 square, Color byColor) const;
+        bool isInCheck(Color color) const;
+
+        // Pseudo-legal moves, these may leave the own king in check.
+        MoveList getAvailableMovesFor(Color color) const;
+        MoveList getLegalMovesFor(Color color) const;
+        // Checks a single move without generating the whole move list.
+        bool isLegal(const Move &move, Color color) const;
+        // Pseudo-legal captures only, generated straight from the attack tables.
+        MoveList getCapturesFor(Color color) const;
+
+        // Material balance for the moving side of the whole exchange sequence started by the move
+        // on its target square, with both sides always recapturing with their least valuable piece.
+        int staticExchange(const Move &move) const;
 
-        bool isPositionInBounds(Vector2 position);
+        // Applies the move and records the captured piece in it.
+        bool makeMove(Move &move);
 
-        std::list<Move> getAvailableMovesFor(Color color);
+        // This board has no castling or en passant, those fields are always "-".
+        std::string toFen(Color toMove, int halfmoveClock, int fullmoveNumber) const;
     };
 }
 
@@ -0,0 +1,133 @@
+#include "capi.h"
+
+#include "board.h"
+#include "move.h"
+
+#include <algorithm>
+
+namespace
+{
+    using namespace Chess;
+
+    static_assert(CH_MAX_MOVES >= MAX_MOVES, "a MoveList never holds more moves than the C API promises");
+
+    // Only material a game can reach is accepted: exactly one king a side, at most 16 pieces a side,
+    // no more promoted pieces than missing pawns and no pawns on the first or last rank.
+    bool hasReachableMaterial(const int *counts, Color color)
+    {
+        auto count = [&](PieceType type)
+        { return counts[Piece::get(type, color)->getCode()]; };
+
+        int pawns = count(PieceType::Pawn);
+        int promoted = std::max(count(PieceType::Queen) - 1, 0) + std::max(count(PieceType::Rook) - 2, 0) +
+                       std::max(count(PieceType::Bishop) - 2, 0) + std::max(count(PieceType::Knight) - 2, 0);
+        int total = pawns + count(PieceType::King) + count(PieceType::Queen) + count(PieceType::Rook) +
+                    count(PieceType::Bishop) + count(PieceType::Knight);
+
+        return count(PieceType::King) == 1 && total <= 16 && pawns + promoted <= BOARD_SIZE;
+    }
+
+    bool loadPosition(const ch_position &position, Board &board, Color &toMove)
+    {
+        const uint8_t whitePawn = Piece::get(PieceType::Pawn, Color::White)->getCode();
+        const uint8_t blackPawn = Piece::get(PieceType::Pawn, Color::Black)->getCode();
+        int counts[1 + 2 * PIECE_TYPE_COUNT] = {};
+
+        for (int index = 0; index < BOARD_SIZE * BOARD_SIZE; index++)
+        {
+            uint8_t code = position.squares[index];
+            int rank = index / BOARD_SIZE;
+
+            if (code > 2 * PIECE_TYPE_COUNT) return false;
+            if ((code == whitePawn || code == blackPawn) && (rank == 0 || rank == BOARD_SIZE - 1)) return false;
+
+            counts[code]++;
+        }
+
+        if (!hasReachableMaterial(counts, Color::White) || !hasReachableMaterial(counts, Color::Black)) return false;
+        if (position.side_to_move > 1) return false;
+
+        board.setPieceCodes(position.squares);
+        toMove = position.side_to_move == 0 ? Color::White : Color::Black;
+
+        return true;
+    }
+
+    ch_move toCMove(const Move &move)
+    {
+        ch_move cMove = ch_move();
+        cMove.from = move.m_from.toIndex();
+        cMove.to = move.m_to.toIndex();
+        cMove.promotion = move.m_promotion != nullptr ? move.m_promotion->getCode() : 0;
+
+        return cMove;
+    }
+}
+
+extern "C"
+{
+    uint32_t ch_api_version(void)
+    {
+        return CH_API_VERSION;
+    }
+
+    size_t ch_count_legal_moves(const ch_position *positions, size_t count, uint32_t *counts)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            Board board;
+            Color toMove;
+
+            counts[i] = loadPosition(positions[i], board, toMove) ? board.getLegalMovesFor(toMove).size() : 0;
+        }
+
+        return count;
+    }
+
+    size_t ch_generate_legal_moves(const ch_position *positions, size_t count, ch_move *moves, size_t move_capacity, uint32_t *offsets)
+    {
+        size_t written = 0;
+        offsets[0] = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Board board;
+            Color toMove;
+            MoveList legalMoves;
+
+            if (loadPosition(positions[i], board, toMove))
+                legalMoves = board.getLegalMovesFor(toMove);
+
+            if (written + legalMoves.size() > move_capacity)
+                return i;
+
+            for (const Move &move : legalMoves)
+            {
+                moves[written++] = toCMove(move);
+            }
+
+            offsets[i + 1] = written;
+        }
+
+        return count;
+    }
+
+    size_t ch_validate_moves(const ch_position *positions, const ch_move *moves, size_t count, uint8_t *valid)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            Board board;
+            Color toMove;
+
+            valid[i] = 0;
+
+            if (!loadPosition(positions[i], board, toMove) || moves[i].from >= 64 || moves[i].to >= 64 || moves[i].promotion > 2 * PIECE_TYPE_COUNT)
+                continue;
+
+            Move move = Move(Vector2::fromIndex(moves[i].from), Vector2::fromIndex(moves[i].to), Piece::fromCode(moves[i].promotion));
+            valid[i] = board.isLegal(move, toMove);
+        }
+
+        return count;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef CAPI_H
+#define CAPI_H
+
+/* Plain C interface to the move generator, built into libch.so.
+ * Every call works on a batch of positions and writes only into buffers owned by the caller,
+ * the library never allocates. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define CH_API __attribute__((visibility("default")))
+
+#define CH_API_VERSION 1
+#define CH_MAX_MOVES 256
+
+    /* Piece codes: 0 empty, 1-6 white king, queen, rook, bishop, knight, pawn, 7-12 the same for black.
+     * Squares are numbered a1 = 0, b1 = 1, ..., h8 = 63. */
+    typedef struct ch_position
+    {
+        uint8_t squares[64];
+        uint8_t side_to_move; /* 0 white, 1 black */
+        uint8_t reserved[7];
+    } ch_position;
+
+    typedef struct ch_move
+    {
+        uint8_t from;
+        uint8_t to;
+        uint8_t promotion; /* piece code, 0 if the move does not promote */
+        uint8_t reserved;
+    } ch_move;
+
+    CH_API uint32_t ch_api_version(void);
+
+    /* A position is malformed if a code is out of range, side_to_move is not 0 or 1, or its material
+     * cannot occur in a game: each side needs exactly one king, at most 16 pieces, no more promoted
+     * pieces than missing pawns, and no pawns on the first or last rank. */
+
+    /* counts[i] receives the number of legal moves in positions[i], or 0 for a malformed position.
+     * Returns the number of positions processed. */
+    CH_API size_t ch_count_legal_moves(const ch_position *positions, size_t count, uint32_t *counts);
+
+    /* Writes the legal moves of all positions back to back into moves. The moves of positions[i] are
+     * moves[offsets[i]] up to moves[offsets[i + 1]], so offsets needs count + 1 entries.
+     * Stops before the first position whose moves would not fit in move_capacity, and returns the
+     * number of positions written. Malformed positions get no moves. Within the material limits above
+     * the most legal moves known in one position is 218, and the library never writes more than
+     * CH_MAX_MOVES for one position. */
+    CH_API size_t ch_generate_legal_moves(const ch_position *positions, size_t count, ch_move *moves, size_t move_capacity, uint32_t *offsets);
+
+    /* valid[i] receives 1 if moves[i] is legal in positions[i], 0 otherwise.
+     * Returns the number of positions processed. */
+    CH_API size_t ch_validate_moves(const ch_position *positions, const ch_move *moves, size_t count, uint8_t *valid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
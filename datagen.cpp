@@ -0,0 +1,359 @@
+#include "datagen.h"
+
+#include "attacks.h"
+#include "search.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Chess
+{
+    namespace
+    {
+        constexpr int SCORE_LIMIT = 32000;
+
+        bool onlyKingsLeft(const Board &board)
+        {
+            return board.getOccupancy() == board.getPieces(PieceType::King);
+        }
+
+        // hashes holds the position hash of every ply of the game so far, the last one is the current position.
+        // Positions an even number of plies apart have the same side to move, and none before the last capture
+        // or pawn move can repeat.
+        bool isThreefoldRepetition(const std::vector<uint64_t> &hashes, int halfmoveClock)
+        {
+            size_t last = hashes.size() - 1;
+            size_t window = std::min((size_t)halfmoveClock, last);
+            int repetitions = 0;
+
+            for (size_t back = 2; back <= window; back += 2)
+            {
+                if (hashes[last - back] == hashes[last] && ++repetitions == 2)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // sampledHashes runs parallel to samples.
+        bool wasSampled(const std::vector<PackedPosition> &samples, const std::vector<uint64_t> &sampledHashes, uint64_t hash, Color toMove)
+        {
+            for (size_t i = 0; i < samples.size(); i++)
+            {
+                if (sampledHashes[i] == hash && (Color)samples[i].m_sideToMove == toMove)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Opens a sample file for appending. A run that died mid-write leaves a partial sample at
+        // the end, it is cut off so new samples stay aligned.
+        std::FILE *openForAppend(const std::string &path)
+        {
+            int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+            if (file < 0)
+                return nullptr;
+
+            struct stat status;
+
+            if (fstat(file, &status) != 0 || ftruncate(file, status.st_size - status.st_size % sizeof(PackedPosition)) != 0)
+            {
+                ::close(file);
+                return nullptr;
+            }
+
+            std::FILE *stream = fdopen(file, "ab");
+
+            if (stream == nullptr)
+                ::close(file);
+
+            return stream;
+        }
+    }
+
+    PackedPosition PackedPosition::pack(const Board &board, Color toMove, int score, int halfmoveClock, int fullmoveNumber)
+    {
+        PackedPosition position = PackedPosition();
+        position.m_occupancy = board.getOccupancy();
+        position.m_score = std::max(-SCORE_LIMIT, std::min(SCORE_LIMIT, score));
+        position.m_sideToMove = (uint8_t)toMove;
+        position.m_fullmoveNumber = std::min(fullmoveNumber, 0xffff);
+        position.m_halfmoveClock = std::min(halfmoveClock, 0xff);
+
+        Bitboard occupied = position.m_occupancy;
+
+        for (int i = 0; occupied != 0 && i < 32; i++)
+        {
+            uint8_t code = board.getSquare(Vector2::fromIndex(Attacks::popLsb(occupied))).getCode();
+            position.m_pieces[i / 2] |= (code - 1) << (4 * (i % 2));
+        }
+
+        return position;
+    }
+
+    Board PackedPosition::unpack() const
+    {
+        uint8_t codes[BOARD_SIZE * BOARD_SIZE] = {};
+        Bitboard occupied = m_occupancy;
+
+        for (int i = 0; occupied != 0 && i < 32; i++)
+        {
+            uint8_t code = ((m_pieces[i / 2] >> (4 * (i % 2))) & 15) + 1;
+            codes[Attacks::popLsb(occupied)] = code <= 2 * PIECE_TYPE_COUNT ? code : 0;
+        }
+
+        Board board;
+        board.setPieceCodes(codes);
+
+        return board;
+    }
+
+    DataGenerator::DataGenerator(const DatagenOptions &options)
+        : m_options(options), m_file(nullptr), m_written(0), m_failed(false)
+    {
+        if (m_options.m_threads == 0) m_options.m_threads = 1;
+    }
+
+    bool DataGenerator::run()
+    {
+        m_file = openForAppend(m_options.m_path);
+
+        if (m_file == nullptr)
+        {
+            std::cerr << "Cannot open " << m_options.m_path << std::endl;
+            return false;
+        }
+
+        m_written = 0;
+        m_failed = false;
+
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < m_options.m_threads; i++)
+        {
+            // spread the games evenly, the first workers take the remainder
+            uint64_t games = m_options.m_games / m_options.m_threads + (i < m_options.m_games % m_options.m_threads ? 1 : 0);
+            workers.emplace_back(&DataGenerator::work, this, i, games);
+        }
+
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+
+        if (std::fclose(m_file) != 0) m_failed = true;
+        m_file = nullptr;
+
+        std::cout << "Wrote " << m_written << " positions to " << m_options.m_path << "." << std::endl;
+
+        return !m_failed;
+    }
+
+    void DataGenerator::writeChunk(std::vector<PackedPosition> &chunk)
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+
+        if (std::fwrite(chunk.data(), sizeof(PackedPosition), chunk.size(), m_file) != chunk.size())
+            m_failed = true;
+
+        m_written += chunk.size();
+        chunk.clear();
+    }
+
+    void DataGenerator::work(size_t worker, uint64_t games)
+    {
+        uint64_t seed = m_options.m_seed + worker;
+        std::mt19937_64 random(splitMix(seed));
+
+        Game game;
+        Search search;
+
+        std::vector<PackedPosition> chunk;
+        chunk.reserve(DATAGEN_CHUNK);
+
+        std::vector<PackedPosition> samples;
+        std::vector<uint64_t> sampledHashes;
+        std::vector<uint64_t> hashes;
+        hashes.reserve(m_options.m_maxPlies);
+
+        for (uint64_t gameIndex = 0; gameIndex < games; gameIndex++)
+        {
+            game.newGame();
+            samples.clear();
+            sampledHashes.clear();
+            hashes.clear();
+
+            // side to move at the end of the game and its result, 0 is a draw
+            Color loser = Color::White;
+            int result = 0;
+
+            for (int ply = 0; ply < m_options.m_maxPlies; ply++)
+            {
+                MoveList moves = game.getLegalMoves();
+                const Board &board = game.getBoard();
+                Color toMove = game.whoIsOnTurn();
+
+                if (moves.size() == 0)
+                {
+                    if (board.isInCheck(toMove))
+                    {
+                        loser = toMove;
+                        result = -1;
+                    }
+
+                    break;
+                }
+
+                hashes.push_back(board.getHash());
+
+                if (game.getHalfmoveClock() >= 100 || onlyKingsLeft(board) || isThreefoldRepetition(hashes, game.getHalfmoveClock()))
+                    break;
+
+                if (ply < m_options.m_randomPlies)
+                {
+                    game.tryToMakeMove(moves[random() % moves.size()]);
+                    continue;
+                }
+
+                SearchResult searched = search.run(board, toMove, m_options.m_depth);
+
+                // only quiet positions make good evaluation targets
+                bool quiet = !board.isInCheck(toMove) && board.getSquare(searched.m_bestMove.m_to).getPiece() == nullptr &&
+                             searched.m_bestMove.m_promotion == nullptr;
+
+                // a position the game returns to is sampled once
+                if (quiet && !wasSampled(samples, sampledHashes, hashes.back(), toMove))
+                {
+                    samples.push_back(PackedPosition::pack(board, toMove, searched.m_score, game.getHalfmoveClock(), game.getFullmoveNumber()));
+                    sampledHashes.push_back(hashes.back());
+                }
+
+                game.tryToMakeMove(searched.m_bestMove);
+            }
+
+            for (PackedPosition &sample : samples)
+            {
+                if (result != 0)
+                    sample.m_result = (Color)sample.m_sideToMove == loser ? -1 : 1;
+
+                chunk.push_back(sample);
+
+                if (chunk.size() == DATAGEN_CHUNK)
+                    writeChunk(chunk);
+            }
+        }
+
+        if (!chunk.empty())
+            writeChunk(chunk);
+    }
+
+    PackedPositionFile::PackedPositionFile()
+        : m_positions(nullptr), m_count(0), m_mappedSize(0)
+    {
+    }
+
+    PackedPositionFile::~PackedPositionFile()
+    {
+        close();
+    }
+
+    void PackedPositionFile::close()
+    {
+        if (m_positions != nullptr)
+            munmap(const_cast<PackedPosition *>(m_positions), m_mappedSize);
+
+        m_positions = nullptr;
+        m_count = 0;
+        m_mappedSize = 0;
+    }
+
+    bool PackedPositionFile::open(const std::string &path)
+    {
+        close();
+
+        int file = ::open(path.c_str(), O_RDONLY);
+
+        if (file < 0)
+            return false;
+
+        struct stat status;
+
+        if (fstat(file, &status) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        // a partially written last sample is ignored, the next DataGenerator run cuts it off
+        m_count = status.st_size / sizeof(PackedPosition);
+
+        if (m_count != 0)
+        {
+            m_mappedSize = status.st_size;
+            void *data = mmap(nullptr, m_mappedSize, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                m_count = 0;
+                m_mappedSize = 0;
+                return false;
+            }
+
+            madvise(data, m_mappedSize, MADV_RANDOM);
+            m_positions = static_cast<const PackedPosition *>(data);
+        }
+
+        ::close(file);
+        return true;
+    }
+
+    size_t PackedPositionFile::size() const
+    {
+        return m_count;
+    }
+
+    const PackedPosition &PackedPositionFile::operator[](size_t index) const
+    {
+        return m_positions[index];
+    }
+
+    ShuffledReader::ShuffledReader(const PackedPositionFile &file, uint64_t seed)
+        : m_file(file), m_mask(0), m_visited(0)
+    {
+        while (m_mask < file.size() - (file.size() != 0))
+            m_mask = m_mask * 2 + 1;
+
+        // a full period LCG modulo a power of two needs multiplier = 1 (mod 4) and an odd increment
+        m_multiplier = (splitMix(seed) << 2 | 1) & m_mask;
+        m_increment = (splitMix(seed) | 1) & m_mask;
+        m_state = splitMix(seed) & m_mask;
+
+        if (m_mask < 3)
+            m_multiplier = 1;
+    }
+
+    const PackedPosition *ShuffledReader::next()
+    {
+        if (m_visited == m_file.size())
+            return nullptr;
+
+        // walk the cycle until it lands inside the file
+        do
+        {
+            m_state = (m_state * m_multiplier + m_increment) & m_mask;
+        } while (m_state >= m_file.size());
+
+        m_visited++;
+        return &m_file[m_state];
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include "board.h"
+#include "game.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Chess
+{
+    // One training sample, 32 bytes. Pieces are stored in the order of the occupancy bits
+    // (a1 first), one nibble each, as Piece::getCode() - 1, the first piece in the low nibble.
+    // Score and result are from the point of view of the side to move.
+    struct PackedPosition
+    {
+        Bitboard m_occupancy;
+        uint8_t m_pieces[16];
+        int16_t m_score;      // centipawns, mate scores clamped
+        int8_t m_result;      // 1 win, 0 draw, -1 loss
+        uint8_t m_sideToMove; // 0 white, 1 black
+        uint16_t m_fullmoveNumber;
+        uint8_t m_halfmoveClock;
+        uint8_t m_reserved;
+
+        static PackedPosition pack(const Board &board, Color toMove, int score, int halfmoveClock, int fullmoveNumber);
+        Board unpack() const;
+    };
+
+    static_assert(sizeof(PackedPosition) == 32, "the packed position layout is part of the file format");
+
+    // Samples are written out in chunks of this many positions.
+    constexpr size_t DATAGEN_CHUNK = 1 << 16;
+
+    struct DatagenOptions
+    {
+        std::string m_path;
+        uint64_t m_games = 1000;
+        size_t m_threads = 1;
+        int m_depth = 4;
+        // random opening moves, so games do not all follow the same line
+        int m_randomPlies = 8;
+        int m_maxPlies = 400;
+        uint64_t m_seed = 1;
+    };
+
+    // Plays games against itself with Search on every thread and appends
+    // one sample per quiet position to a file of PackedPositions. Threefold repetition
+    // ends a game as a draw, and a position is sampled at most once per game.
+    class DataGenerator
+    {
+        DatagenOptions m_options;
+
+        std::mutex m_fileMutex;
+        std::FILE *m_file;
+        uint64_t m_written;
+        bool m_failed;
+
+        void work(size_t worker, uint64_t games);
+        void writeChunk(std::vector<PackedPosition> &chunk);
+
+    public:
+        DataGenerator(const DatagenOptions &options);
+
+        // Returns false if the file could not be written.
+        bool run();
+    };
+
+    // Maps a file of PackedPositions for random access.
+    class PackedPositionFile
+    {
+        const PackedPosition *m_positions;
+        size_t m_count;
+        size_t m_mappedSize;
+
+        void close();
+
+    public:
+        PackedPositionFile();
+        ~PackedPositionFile();
+
+        PackedPositionFile(const PackedPositionFile &) = delete;
+        PackedPositionFile &operator=(const PackedPositionFile &) = delete;
+
+        bool open(const std::string &path);
+
+        size_t size() const;
+        const PackedPosition &operator[](size_t index) const;
+    };
+
+    // Visits every position of a file exactly once in a seeded pseudo-random order,
+    // without materialising a permutation, so it works for any file size.
+    class ShuffledReader
+    {
+        const PackedPositionFile &m_file;
+        uint64_t m_mask;
+        uint64_t m_multiplier;
+        uint64_t m_increment;
+        uint64_t m_state;
+        uint64_t m_visited;
+
+    public:
+        ShuffledReader(const PackedPositionFile &file, uint64_t seed);
+
+        // Returns nullptr once every position has been read.
+        const PackedPosition *next();
+    };
+}
+
+#endif
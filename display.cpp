@@ -5,17 +5,16 @@
 
 namespace Chess
 {
-    std::shared_ptr<Move> Display::getInput()
+    Move Display::getInput()
     {
         std::string input;
-        std::shared_ptr<Move> move = std::shared_ptr<Move>();
 
         while (true)
         {
             std::cout << "What move do you want to play?" << std::endl;
             input = "";
             std::cin >> input;
-            if (input.length() < 4 && input.length() > 5)
+            if (input.length() < 4 || input.length() > 5)
             {
                 std::cout << "Invalid input! Write move in format [a1-h8][a1-h8](+ Q/R/B/N when promoting). For example: 'e2e4'." << std::endl;
                 continue;
@@ -24,30 +23,32 @@ namespace Chess
             Vector2 from = Vector2(input.substr(0, 2));
             Vector2 to = Vector2(input.substr(2, 2));
 
-            if (!m_game.getBoard()->isPositionInBounds(from) || !m_game.getBoard()->isPositionInBounds(to))
+            if (!m_game.getBoard().isPositionInBounds(from) || !m_game.getBoard().isPositionInBounds(to))
             {
                 std::cout << "Position is out of bounds! FROM = " << from.toString() << ", TO = " << to.toString() << "." << std::endl;
                 continue;
             }
 
+            Move move = Move(from, to);
+
             if (input.length() == 5) // Promotion
             {
                 switch (input[4])
                 {
                 case 'Q':
-                    move->m_promotion = std::make_shared<Queen>(m_game.whoIsOnTurn());
+                    move.m_promotion = Piece::get(PieceType::Queen, m_game.whoIsOnTurn());
                     break;
 
                 case 'R':
-                    move->m_promotion = std::make_shared<Rook>(m_game.whoIsOnTurn());
+                    move.m_promotion = Piece::get(PieceType::Rook, m_game.whoIsOnTurn());
                     break;
 
                 case 'B':
-                    move->m_promotion = std::make_shared<Bishop>(m_game.whoIsOnTurn());
+                    move.m_promotion = Piece::get(PieceType::Bishop, m_game.whoIsOnTurn());
                     break;
 
                 case 'N':
-                    move->m_promotion = std::make_shared<Knight>(m_game.whoIsOnTurn());
+                    move.m_promotion = Piece::get(PieceType::Knight, m_game.whoIsOnTurn());
                     break;
                 
                 default:
@@ -56,9 +57,6 @@ namespace Chess
                 }
             }
 
-            move->m_from = m_game.getBoard()->getSquare(from);
-            move->m_to = m_game.getBoard()->getSquare(to);
-
             return move;
         }
     }
@@ -70,32 +68,32 @@ namespace Chess
 
         std::cout << " to move." << std::endl;
 
-        std::vector<std::vector<std::shared_ptr<Square>>> squares = m_game.getBoard()->getSquares();
+        const Board &board = m_game.getBoard();
 
         std::cout << " ";
 
-        for (size_t x = 0; x < squares.size(); x++)
+        for (int x = 0; x < BOARD_SIZE; x++)
         {
             std::cout << "-";
         }
 
         std::cout << std::endl;
 
-        for (size_t y = squares.size(); y > 0; y--)
+        for (int y = BOARD_SIZE; y > 0; y--)
         {
             std::cout << "|";
 
-            for (size_t x = 0; x < squares.size(); x++)
+            for (int x = 0; x < BOARD_SIZE; x++)
             {
-                std::shared_ptr<Square> square = squares[x][y - 1];
-                std::shared_ptr<Piece> piece = square->getPiece();
+                const Square &square = board.getSquare(Vector2(x, y - 1));
+                const Piece *piece = square.getPiece();
 
                 if (piece != nullptr && piece->getColor() == Color::White)
                 {
                     std::cout << "\u001b[30m\u001b[47m";
                 }
 
-                std::cout << squares[x][y - 1]->getAsciiRepresentation() << "\u001b[0m";
+                std::cout << square.getAsciiRepresentation() << "\u001b[0m";
             }
 
             std::cout << "|" << y << std::endl;
@@ -103,14 +101,14 @@ namespace Chess
 
         std::cout << " ";
 
-        for (size_t x = 0; x < squares.size(); x++)
+        for (int x = 0; x < BOARD_SIZE; x++)
         {
             std::cout << "-";
         }
 
         std::cout << std::endl << " ";
 
-        for (size_t x = 0; x < squares.size(); x++)
+        for (int x = 0; x < BOARD_SIZE; x++)
         {
             std::cout << (char)(x + 97);
         }
@@ -128,7 +126,7 @@ namespace Chess
         while (true)
         {
             print();
-            std::shared_ptr<Move> move = getInput();
+            Move move = getInput();
             if (!m_game.tryToMakeMove(move))
             {
                 std::cout << "That move is not valid!" << std::endl;
@@ -3,8 +3,6 @@
 
 #include "game.h"
 
-#include <memory>
-
 namespace Chess
 {
 
@@ -12,7 +10,7 @@ namespace Chess
     {
         Game &m_game;
 
-        std::shared_ptr<Move> getInput();
+        Move getInput();
         void print();
 
     public:
@@ -1,59 +1,161 @@
 #include "game.h"
 
+#include "attacks.h"
+
 namespace Chess
 {
-    std::list<Move> Game::getAvailableMoves()
+    void Game::updateLegalMoves()
+    {
+        if (m_legalValid && m_legalHash == m_board.getHash() && m_legalToMove == m_toMove)
+            return;
+
+        m_legalTargets.fill(0);
+
+        for (const Move &move : m_board.getLegalMovesFor(m_toMove))
+        {
+            m_legalTargets[move.m_from.toIndex()] |= (Bitboard)1 << move.m_to.toIndex();
+        }
+
+        m_legalHash = m_board.getHash();
+        m_legalToMove = m_toMove;
+        m_legalValid = true;
+    }
+
+    bool Game::isPromotion(const Move &move) const
     {
-        return m_board->getAvailableMovesFor(m_toMove);
+        const Piece *piece = m_board.getSquare(move.m_from).getPiece();
+        int lastRow = m_toMove == Color::White ? BOARD_SIZE - 1 : 0;
+
+        return piece->getType() == PieceType::Pawn && move.m_to.m_y == lastRow;
     }
 
     Game::Game()
+        : m_legalValid(false)
     {
+        m_history.reserve(HISTORY_RESERVE);
         newGame();
     }
 
     bool Game::newGame()
     {
-        m_board = std::make_shared<Board>();
-        m_board->initDefault();
+        m_board.initDefault();
         m_toMove = Color::White;
-        m_history = std::list<std::shared_ptr<Move>>();
+        m_halfmoveClock = 0;
+        m_fullmoveNumber = 1;
+        m_history.clear(); // keeps the buffer for the next game
+        m_legalValid = false;
+        return true;
+    }
+
+    bool Game::restore(const Board &board, Color toMove, int halfmoveClock, int fullmoveNumber)
+    {
+        m_board = board;
+        m_toMove = toMove;
+        m_halfmoveClock = halfmoveClock;
+        m_fullmoveNumber = fullmoveNumber;
+        m_history.clear(); // keeps the buffer, restoring into a reused Game does not allocate
+        m_legalValid = false;
+        return true;
+    }
+
+    bool Game::appendHistory(const Move &move)
+    {
+        m_history.push_back(move);
         return true;
     }
 
-    std::shared_ptr<Board> Game::getBoard()
+    const Board &Game::getBoard() const
     {
         return m_board;
     }
 
-    bool Game::tryToMakeMove(std::shared_ptr<Move> move)
+    const std::vector<Move> &Game::getHistory() const
     {
-        std::list<Move> allMoves = getAvailableMoves();
+        return m_history;
+    }
+
+    bool Game::tryToMakeMove(const Move &move)
+    {
+        if (!m_board.isPositionInBounds(move.m_from) || !m_board.isPositionInBounds(move.m_to))
+            return false;
+
+        updateLegalMoves();
+
+        if (((m_legalTargets[move.m_from.toIndex()] >> move.m_to.toIndex()) & 1) == 0)
+            return false;
+
+        // the table only knows squares, promotions are checked here
+        if (isPromotion(move) != (move.m_promotion != nullptr))
+            return false;
 
-        for (const Move &currentMove: allMoves)
+        if (move.m_promotion != nullptr)
         {
-            if (currentMove == *move)
-            {
-                m_history.push_back(move);
+            PieceType type = move.m_promotion->getType();
+
+            if (move.m_promotion->getColor() != m_toMove || type == PieceType::King || type == PieceType::Pawn)
+                return false;
+        }
+
+        Move played = Move(move.m_from, move.m_to, move.m_promotion);
+        bool pawnMove = m_board.getSquare(played.m_from).getPiece()->getType() == PieceType::Pawn;
+
+        m_board.makeMove(played);
+        m_history.push_back(played);
+        m_legalValid = false;
+
+        if (pawnMove || played.m_captured != nullptr) m_halfmoveClock = 0;
+        else m_halfmoveClock++;
 
-                move->m_captured = move->m_to->getPiece();
-                move->m_to->setPiece(move->m_from->getPiece());
-                move->m_from->setPiece(nullptr);
+        if (m_toMove == Color::Black) m_fullmoveNumber++;
+
+        if (m_toMove == Color::White) m_toMove = Color::Black;
+        else m_toMove = Color::White;
+
+        return true;
+    }
+
+    MoveList Game::getLegalMoves()
+    {
+        updateLegalMoves();
 
-                if (move->m_promotion != nullptr)
+        MoveList moves;
+
+        for (int from = 0; from < BOARD_SIZE * BOARD_SIZE; from++)
+        {
+            Bitboard targets = m_legalTargets[from];
+
+            while (targets != 0)
+            {
+                Move move = Move(Vector2::fromIndex(from), Vector2::fromIndex(Attacks::popLsb(targets)));
+
+                if (!isPromotion(move))
                 {
-                    move->m_to->setPiece(move->m_promotion);
+                    moves.add(move);
+                    continue;
                 }
 
-                return true;
+                moves.add(Move(move.m_from, move.m_to, Piece::get(PieceType::Queen, m_toMove)));
+                moves.add(Move(move.m_from, move.m_to, Piece::get(PieceType::Rook, m_toMove)));
+                moves.add(Move(move.m_from, move.m_to, Piece::get(PieceType::Bishop, m_toMove)));
+                moves.add(Move(move.m_from, move.m_to, Piece::get(PieceType::Knight, m_toMove)));
             }
         }
 
-        return false;
+        return moves;
     }
 
-    Color Game::whoIsOnTurn()
+    Color Game::whoIsOnTurn() const
     {
         return m_toMove;
     }
-}
\ No newline at end of file
+
+    int Game::getHalfmoveClock() const
+    {
+        return m_halfmoveClock;
+    }
+
+    int Game::getFullmoveNumber() const
+    {
+        return m_fullmoveNumber;
+    }
+}
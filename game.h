@@ -5,30 +5,51 @@
 #include "board.h"
 #include "move.h"
 
-#include <memory>
-#include <list>
+#include <array>
+#include <vector>
 
 namespace Chess
 {
+    // Moves reserved up front so a typical game never grows its history.
+    constexpr size_t HISTORY_RESERVE = 256;
+
     class Game
     {
 
-        std::shared_ptr<Board> m_board;
+        Board m_board;
         Color m_toMove;
-        std::list<std::shared_ptr<Move>> m_history;
+        int m_halfmoveClock;
+        int m_fullmoveNumber;
+        std::vector<Move> m_history;
+
+        // Legal target squares for every from-square, computed once per position and
+        // dropped only when a move is applied.
+        std::array<Bitboard, BOARD_SIZE * BOARD_SIZE> m_legalTargets;
+        uint64_t m_legalHash;
+        Color m_legalToMove;
+        bool m_legalValid;
 
-        std::list<Move> getAvailableMoves();
+        void updateLegalMoves();
+        bool isPromotion(const Move &move) const;
 
     public:
         Game();
 
         bool newGame();
+        // Replaces the whole game state and empties the history, keeping its buffer.
+        // The moves that led to the position are then added in order with appendHistory().
+        bool restore(const Board &board, Color toMove, int halfmoveClock, int fullmoveNumber);
+        bool appendHistory(const Move &move);
 
-        std::shared_ptr<Board> getBoard();
+        const Board &getBoard() const;
+        const std::vector<Move> &getHistory() const;
 
-        bool tryToMakeMove(std::shared_ptr<Move> move);
+        bool tryToMakeMove(const Move &move);
+        MoveList getLegalMoves();
 
-        Color whoIsOnTurn();
+        Color whoIsOnTurn() const;
+        int getHalfmoveClock() const;
+        int getFullmoveNumber() const;
     };
 }
 
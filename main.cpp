@@ -1,13 +1,41 @@
 #include <iostream>
+#include <string>
+#include <thread>
 #include "board.h"
 
+#include "datagen.h"
 #include "display.h"
 #include "game.h"
+#include "server.h"
+#include "session.h"
 
-int main ()
+int main (int argc, char *argv[])
 {
     std::cout << "Starting..." << std::endl;
 
+    if (argc >= 3 && std::string(argv[1]) == "--server")
+    {
+        size_t threads = argc >= 4 ? std::stoul(argv[3]) : std::thread::hardware_concurrency();
+
+        Chess::SessionManager sessions = Chess::SessionManager(threads);
+        Chess::Server server = Chess::Server(sessions, argv[2], threads);
+
+        return server.run() ? 0 : 1;
+    }
+
+    if (argc >= 4 && std::string(argv[1]) == "--datagen")
+    {
+        Chess::DatagenOptions options;
+        options.m_path = argv[2];
+        options.m_games = std::stoull(argv[3]);
+        options.m_threads = argc >= 5 ? std::stoul(argv[4]) : std::thread::hardware_concurrency();
+        if (argc >= 6) options.m_depth = std::stoi(argv[5]);
+
+        Chess::DataGenerator generator = Chess::DataGenerator(options);
+
+        return generator.run() ? 0 : 1;
+    }
+
     Chess::Game chessGame = Chess::Game();
     Chess::Display chessDisplay = Chess::Display(chessGame);
 
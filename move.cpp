@@ -3,18 +3,120 @@
 namespace Chess
 {
   Move::Move()
+    : m_promotion(nullptr), m_captured(nullptr)
   {
   }
 
-  Move::Move(std::shared_ptr<Square> from, std::shared_ptr<Square> to, std::shared_ptr<Piece> promotion)
-    : m_from(from), m_to(to), m_promotion(promotion)
+  Move::Move(Vector2 from, Vector2 to, const Piece *promotion)
+    : m_from(from), m_to(to), m_promotion(promotion), m_captured(nullptr)
   {
   }
 
   bool Move::operator==(const Move &other) const
   {
-    if (m_from == other.m_from && m_to == other.m_to && (m_promotion == other.m_promotion || *m_promotion == *(other.m_promotion))) return true;
+    // pieces are flyweights, so comparing the pointers compares the pieces
+    if (m_from == other.m_from && m_to == other.m_to && m_promotion == other.m_promotion) return true;
 
     return false;
   }
+
+  std::string Move::toString() const
+  {
+    std::string text = m_from.toAlgebraic() + m_to.toAlgebraic();
+
+    if (m_promotion != nullptr)
+    {
+      text += (char)(m_promotion->getAsciiRepresentation() - 'A' + 'a');
+    }
+
+    return text;
+  }
+
+  bool Move::fromString(const std::string &text, Color color, Move &move)
+  {
+    if (text.length() < 4 || text.length() > 5) return false;
+
+    move = Move(Vector2(text.substr(0, 2)), Vector2(text.substr(2, 2)));
+
+    if (move.m_from.m_x < 0 || move.m_from.m_x >= BOARD_SIZE || move.m_from.m_y < 0 || move.m_from.m_y >= BOARD_SIZE ||
+        move.m_to.m_x < 0 || move.m_to.m_x >= BOARD_SIZE || move.m_to.m_y < 0 || move.m_to.m_y >= BOARD_SIZE)
+      return false;
+
+    if (text.length() == 5)
+    {
+      switch (text[4])
+      {
+      case 'q':
+        move.m_promotion = Piece::get(PieceType::Queen, color);
+        break;
+      case 'r':
+        move.m_promotion = Piece::get(PieceType::Rook, color);
+        break;
+      case 'b':
+        move.m_promotion = Piece::get(PieceType::Bishop, color);
+        break;
+      case 'n':
+        move.m_promotion = Piece::get(PieceType::Knight, color);
+        break;
+      default:
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  MoveList::MoveList()
+    : m_size(0)
+  {
+  }
+
+  bool MoveList::add(const Move &move)
+  {
+    if (m_size == MAX_MOVES)
+      return false;
+
+    m_moves[m_size++] = move;
+    return true;
+  }
+
+  void MoveList::clear()
+  {
+    m_size = 0;
+  }
+
+  size_t MoveList::size() const
+  {
+    return m_size;
+  }
+
+  Move &MoveList::operator[](size_t index)
+  {
+    return m_moves[index];
+  }
+
+  const Move &MoveList::operator[](size_t index) const
+  {
+    return m_moves[index];
+  }
+
+  Move *MoveList::begin()
+  {
+    return m_moves.data();
+  }
+
+  Move *MoveList::end()
+  {
+    return m_moves.data() + m_size;
+  }
+
+  const Move *MoveList::begin() const
+  {
+    return m_moves.data();
+  }
+
+  const Move *MoveList::end() const
+  {
+    return m_moves.data() + m_size;
+  }
 }
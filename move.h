@@ -1,10 +1,12 @@
 #ifndef MOVE_H
 #define MOVE_H
 
-#include "square.h"
+#include "primitives.h"
 #include "pieces.h"
 
-#include <memory>
+#include <array>
+#include <cstddef>
+#include <string>
 
 namespace Chess
 {
@@ -12,14 +14,44 @@ namespace Chess
   {
   public:
     Move();
-    Move(std::shared_ptr<Square> from, std::shared_ptr<Square> to, std::shared_ptr<Piece> promotion = nullptr); 
-    std::shared_ptr<Square> m_from;
-    std::shared_ptr<Square> m_to;
-    std::shared_ptr<Piece> m_promotion;
-    std::shared_ptr<Piece> m_captured;
+    Move(Vector2 from, Vector2 to, const Piece *promotion = nullptr);
+    Vector2 m_from;
+    Vector2 m_to;
+    const Piece *m_promotion;
+    const Piece *m_captured;
 
     bool operator==(const Move& other) const;
+
+    // Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q".
+    std::string toString() const;
+    static bool fromString(const std::string &text, Color color, Move &move);
+  };
+
+  // No legal position has more than 218 moves.
+  constexpr size_t MAX_MOVES = 256;
+
+  // Fixed capacity move container, lives on the stack so move generation never allocates.
+  // Moves added past MAX_MOVES are dropped, which only malformed positions can reach.
+  class MoveList
+  {
+    std::array<Move, MAX_MOVES> m_moves;
+    size_t m_size;
+
+  public:
+    MoveList();
+
+    bool add(const Move &move);
+    void clear();
+    size_t size() const;
+
+    Move &operator[](size_t index);
+    const Move &operator[](size_t index) const;
+
+    Move *begin();
+    Move *end();
+    const Move *begin() const;
+    const Move *end() const;
   };
 }
 
-#endif
\ No newline at end of file
+#endif
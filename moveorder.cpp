@@ -0,0 +1,164 @@
+#include "moveorder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Chess
+{
+    namespace
+    {
+        constexpr int GOOD_CAPTURE_SCORE = 2000000;
+        constexpr int KILLER_SCORE = 1000000;
+        constexpr int COUNTER_MOVE_SCORE = 900000;
+        constexpr int BAD_CAPTURE_SCORE = -2000000;
+
+        bool isQuiet(const Board &board, const Move &move)
+        {
+            return move.m_promotion == nullptr && board.getSquare(move.m_to).getPiece() == nullptr;
+        }
+
+        int mvvLva(const Board &board, const Move &move)
+        {
+            const Piece *victim = board.getSquare(move.m_to).getPiece();
+            const Piece *attacker = board.getSquare(move.m_from).getPiece();
+
+            int score = 0;
+
+            if (victim != nullptr)
+                score += PIECE_VALUES[(int)victim->getType()] * 16;
+
+            if (move.m_promotion != nullptr)
+                score += (PIECE_VALUES[(int)move.m_promotion->getType()] - PIECE_VALUES[(int)PieceType::Pawn]) * 16;
+
+            // a king is worth 20000, keep it the least attractive attacker without overflowing the victim term
+            return score - std::min(PIECE_VALUES[(int)attacker->getType()], PIECE_VALUES[(int)PieceType::Queen] + 100) / 10;
+        }
+    }
+
+    MoveOrdering::MoveOrdering()
+    {
+        clear();
+    }
+
+    void MoveOrdering::clear()
+    {
+        for (auto &killers : m_killers)
+            killers.fill(Move());
+
+        for (auto &side : m_history)
+            for (auto &from : side)
+                from.fill(0);
+
+        for (auto &piece : m_counterMoves)
+            piece.fill(Move());
+    }
+
+    void MoveOrdering::decay()
+    {
+        for (auto &killers : m_killers)
+            killers.fill(Move());
+
+        for (auto &side : m_history)
+            for (auto &from : side)
+                for (int &score : from)
+                    score /= 2;
+    }
+
+    void MoveOrdering::scoreMoves(const Board &board, Color color, const MoveList &moves, int ply, const Move *previous, MoveScores &scores) const
+    {
+        const Move *counterMove = nullptr;
+
+        if (previous != nullptr)
+        {
+            const Piece *moved = board.getSquare(previous->m_to).getPiece();
+            counterMove = &m_counterMoves[moved->getCode()][previous->m_to.toIndex()];
+        }
+
+        const auto &killers = m_killers[std::min(ply, ORDERING_MAX_PLY - 1)];
+
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            const Move &move = moves[i];
+
+            if (!isQuiet(board, move))
+            {
+                // queen promotions count as winning material, underpromotions go last
+                if (move.m_promotion != nullptr && move.m_promotion->getType() != PieceType::Queen)
+                    scores[i] = BAD_CAPTURE_SCORE + mvvLva(board, move);
+                else if (board.staticExchange(move) >= 0)
+                    scores[i] = GOOD_CAPTURE_SCORE + mvvLva(board, move);
+                else
+                    scores[i] = BAD_CAPTURE_SCORE + mvvLva(board, move);
+            }
+            else if (move == killers[0])
+                scores[i] = KILLER_SCORE + 1;
+            else if (move == killers[1])
+                scores[i] = KILLER_SCORE;
+            else if (counterMove != nullptr && move == *counterMove)
+                scores[i] = COUNTER_MOVE_SCORE;
+            else
+                scores[i] = m_history[(int)color][move.m_from.toIndex()][move.m_to.toIndex()];
+        }
+    }
+
+    void MoveOrdering::scoreCaptures(const Board &board, const MoveList &moves, MoveScores &scores)
+    {
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            scores[i] = mvvLva(board, moves[i]);
+        }
+    }
+
+    const Move &MoveOrdering::pickNext(MoveList &moves, MoveScores &scores, size_t index)
+    {
+        size_t best = index;
+
+        for (size_t i = index + 1; i < moves.size(); i++)
+        {
+            if (scores[i] > scores[best])
+                best = i;
+        }
+
+        std::swap(moves[index], moves[best]);
+        std::swap(scores[index], scores[best]);
+
+        return moves[index];
+    }
+
+    void MoveOrdering::updateHistory(Color color, const Move &move, int bonus)
+    {
+        int &score = m_history[(int)color][move.m_from.toIndex()][move.m_to.toIndex()];
+
+        // history gravity, the closer a score is to the limit the less it moves
+        score += bonus - score * std::abs(bonus) / HISTORY_MAX;
+    }
+
+    void MoveOrdering::recordCutoff(const Board &board, Color color, const MoveList &moves, const SearchedMoves &searched, size_t cutoffIndex, int depth, int ply, const Move *previous)
+    {
+        const Move &move = moves[cutoffIndex];
+        auto &killers = m_killers[std::min(ply, ORDERING_MAX_PLY - 1)];
+
+        if (!(move == killers[0]))
+        {
+            killers[1] = killers[0];
+            killers[0] = move;
+        }
+
+        int bonus = std::min(depth * depth, HISTORY_MAX / 16);
+
+        updateHistory(color, move, bonus);
+
+        // moves skipped as illegal were never searched and say nothing about their history
+        for (size_t i = 0; i < cutoffIndex; i++)
+        {
+            if (searched[i] && isQuiet(board, moves[i]))
+                updateHistory(color, moves[i], -bonus);
+        }
+
+        if (previous != nullptr)
+        {
+            const Piece *moved = board.getSquare(previous->m_to).getPiece();
+            m_counterMoves[moved->getCode()][previous->m_to.toIndex()] = move;
+        }
+    }
+}
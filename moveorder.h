@@ -0,0 +1,52 @@
+#ifndef MOVEORDER_H
+#define MOVEORDER_H
+
+#include "board.h"
+#include "move.h"
+
+#include <array>
+#include <bitset>
+
+namespace Chess
+{
+    constexpr int ORDERING_MAX_PLY = 128;
+    // History scores stay within +-HISTORY_MAX, below the killer and countermove bonuses.
+    constexpr int HISTORY_MAX = 16384;
+
+    using MoveScores = std::array<int, MAX_MOVES>;
+    // Marks the moves a node actually searched, indexed like its MoveList.
+    using SearchedMoves = std::bitset<MAX_MOVES>;
+
+    // Ranks captures by MVV-LVA, with losing captures by SEE placed after the quiet moves,
+    // and quiet moves by killer slots, the countermove table and butterfly history.
+    // The tables are not synchronised, every searching thread owns its own MoveOrdering.
+    class MoveOrdering
+    {
+        std::array<std::array<Move, 2>, ORDERING_MAX_PLY> m_killers;
+        // [color][from][to]
+        std::array<std::array<std::array<int, BOARD_SIZE * BOARD_SIZE>, BOARD_SIZE * BOARD_SIZE>, 2> m_history;
+        // [piece code of the previous move][its target square]
+        std::array<std::array<Move, BOARD_SIZE * BOARD_SIZE>, 1 + 2 * PIECE_TYPE_COUNT> m_counterMoves;
+
+        void updateHistory(Color color, const Move &move, int bonus);
+
+    public:
+        MoveOrdering();
+
+        void clear();
+        // Called between searches, forgets killers and fades the history so new positions can take over.
+        void decay();
+
+        // previous is the move that led to board, or nullptr at the root.
+        void scoreMoves(const Board &board, Color color, const MoveList &moves, int ply, const Move *previous, MoveScores &scores) const;
+        static void scoreCaptures(const Board &board, const MoveList &moves, MoveScores &scores);
+
+        // Moves the best scored move not yet searched to index and returns it.
+        static const Move &pickNext(MoveList &moves, MoveScores &scores, size_t index);
+
+        // moves[cutoffIndex] is a quiet move that caused a beta cutoff, the searched moves picked before it did not.
+        void recordCutoff(const Board &board, Color color, const MoveList &moves, const SearchedMoves &searched, size_t cutoffIndex, int depth, int ply, const Move *previous);
+    };
+}
+
+#endif
@@ -5,31 +5,49 @@
 
 namespace Chess
 {
-
-    std::list<Move> Piece::checkJumpMove(Vector2 position, Board &board, Vector2 offset, bool canTake, bool mustTake)
+    namespace
     {
-        std::list<Move> move = std::list<Move>();
+        const King whiteKing(Color::White);
+        const Queen whiteQueen(Color::White);
+        const Rook whiteRook(Color::White);
+        const Bishop whiteBishop(Color::White);
+        const Knight whiteKnight(Color::White);
+        const Pawn whitePawn(Color::White);
+
+        const King blackKing(Color::Black);
+        const Queen blackQueen(Color::Black);
+        const Rook blackRook(Color::Black);
+        const Bishop blackBishop(Color::Black);
+        const Knight blackKnight(Color::Black);
+        const Pawn blackPawn(Color::Black);
 
+        // Indexed by piece code.
+        const Piece *const flyweights[1 + 2 * PIECE_TYPE_COUNT] = {
+            nullptr,
+            &whiteKing, &whiteQueen, &whiteRook, &whiteBishop, &whiteKnight, &whitePawn,
+            &blackKing, &blackQueen, &blackRook, &blackBishop, &blackKnight, &blackPawn};
+    }
+
+    bool Piece::checkJumpMove(Vector2 position, const Board &board, Vector2 offset, MoveList &moves, bool canTake, bool mustTake) const
+    {
         Vector2 positionAfterJump = position + offset;
 
         if (!board.isPositionInBounds(positionAfterJump))
-            return move;
+            return false;
 
-        std::shared_ptr<Piece> piece = board.getSquare(positionAfterJump)->getPiece();
+        const Piece *piece = board.getSquare(positionAfterJump).getPiece();
 
-        if ((piece == nullptr && !mustTake) || (piece->getColor() != m_color && canTake))
+        if ((piece == nullptr && !mustTake) || (piece != nullptr && piece->getColor() != m_color && canTake))
         {
-            move.emplace_back(board.getSquare(position), board.getSquare(positionAfterJump));
-            return move;
+            moves.add(Move(position, positionAfterJump));
+            return true;
         }
 
-        return move;
+        return false;
     }
 
-    std::list<Move> Piece::checkSlideMove(Vector2 position, Board &board, Vector2 offset)
+    void Piece::checkSlideMove(Vector2 position, const Board &board, Vector2 offset, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
         Vector2 currentPosition = position;
 
         while (true)
@@ -39,11 +57,11 @@ namespace Chess
             if (!board.isPositionInBounds(currentPosition))
                 break;
 
-            std::shared_ptr<Piece> piece = board.getSquare(currentPosition)->getPiece();
+            const Piece *piece = board.getSquare(currentPosition).getPiece();
 
             if (piece == nullptr) // empty square
             {
-                availableMoves.emplace_back(board.getSquare(position), board.getSquare(currentPosition));
+                moves.add(Move(position, currentPosition));
                 continue;
             }
 
@@ -53,172 +71,169 @@ namespace Chess
             }
 
             // else different color
-            availableMoves.emplace_back(board.getSquare(position), board.getSquare(currentPosition));
+            moves.add(Move(position, currentPosition));
             break;
         }
+    }
+
+    Piece::Piece(Color color, PieceType type)
+        : m_color(color), m_type(type)
+    {
+    }
 
-        return availableMoves;
+    const Piece *Piece::get(PieceType type, Color color)
+    {
+        return flyweights[1 + (int)type + (color == Color::Black ? PIECE_TYPE_COUNT : 0)];
     }
 
-    Piece::Piece(Color color)
-        : m_color(color)
+    const Piece *Piece::fromCode(uint8_t code)
     {
+        if (code > 2 * PIECE_TYPE_COUNT) return nullptr;
+        return flyweights[code];
     }
 
-    char Piece::getAsciiRepresentation()
+    uint8_t Piece::getCode() const
+    {
+        return 1 + (int)m_type + (m_color == Color::Black ? PIECE_TYPE_COUNT : 0);
+    }
+
+    char Piece::getAsciiRepresentation() const
     {
         return m_asciiRepresentation;
     }
 
-    Color Piece::getColor()
+    Color Piece::getColor() const
     {
         return m_color;
     }
 
+    PieceType Piece::getType() const
+    {
+        return m_type;
+    }
+
     bool Piece::operator==(const Piece &other) const
     {
-        if (m_asciiRepresentation == other.m_asciiRepresentation && m_color == other.m_color) return true;
+        if (m_type == other.m_type && m_color == other.m_color) return true;
         return false;
     }
 
     King::King(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::King)
     {
         m_asciiRepresentation = 'K';
     }
 
-    std::list<Move> King::getAvailableMoves(Vector2 position, Board &board)
+    void King::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, -1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, 0)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, 1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(0, -1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(0, 1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, -1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, 0)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, 1)));
-
-        return availableMoves;
+        checkJumpMove(position, board, Vector2(-1, -1), moves);
+        checkJumpMove(position, board, Vector2(-1, 0), moves);
+        checkJumpMove(position, board, Vector2(-1, 1), moves);
+        checkJumpMove(position, board, Vector2(0, -1), moves);
+        checkJumpMove(position, board, Vector2(0, 1), moves);
+        checkJumpMove(position, board, Vector2(1, -1), moves);
+        checkJumpMove(position, board, Vector2(1, 0), moves);
+        checkJumpMove(position, board, Vector2(1, 1), moves);
     }
 
     Queen::Queen(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::Queen)
     {
         m_asciiRepresentation = 'Q';
     }
-    std::list<Move> Queen::getAvailableMoves(Vector2 position, Board &board)
+    void Queen::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, 0)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, 1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(0, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(0, 1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, 0)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, 1)));
-
-        return availableMoves;
+        checkSlideMove(position, board, Vector2(-1, -1), moves);
+        checkSlideMove(position, board, Vector2(-1, 0), moves);
+        checkSlideMove(position, board, Vector2(-1, 1), moves);
+        checkSlideMove(position, board, Vector2(0, -1), moves);
+        checkSlideMove(position, board, Vector2(0, 1), moves);
+        checkSlideMove(position, board, Vector2(1, -1), moves);
+        checkSlideMove(position, board, Vector2(1, 0), moves);
+        checkSlideMove(position, board, Vector2(1, 1), moves);
     }
     Rook::Rook(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::Rook)
     {
         m_asciiRepresentation = 'R';
     }
 
-    std::list<Move> Rook::getAvailableMoves(Vector2 position, Board &board)
+    void Rook::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, 0)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(0, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(0, 1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, 0)));
-
-        return availableMoves;
+        checkSlideMove(position, board, Vector2(-1, 0), moves);
+        checkSlideMove(position, board, Vector2(0, -1), moves);
+        checkSlideMove(position, board, Vector2(0, 1), moves);
+        checkSlideMove(position, board, Vector2(1, 0), moves);
     }
 
     Bishop::Bishop(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::Bishop)
     {
         m_asciiRepresentation = 'B';
     }
 
-    std::list<Move> Bishop::getAvailableMoves(Vector2 position, Board &board)
+    void Bishop::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(-1, 1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, -1)));
-        availableMoves.splice(availableMoves.end(), checkSlideMove(position, board, Vector2(1, 1)));
-
-        return availableMoves;
+        checkSlideMove(position, board, Vector2(-1, -1), moves);
+        checkSlideMove(position, board, Vector2(-1, 1), moves);
+        checkSlideMove(position, board, Vector2(1, -1), moves);
+        checkSlideMove(position, board, Vector2(1, 1), moves);
     }
 
     Knight::Knight(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::Knight)
     {
         m_asciiRepresentation = 'N';
     }
 
-    std::list<Move> Knight::getAvailableMoves(Vector2 position, Board &board)
+    void Knight::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-2, -1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-2, 1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, -2)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, 2)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, -2)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, 2)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(2, -1)));
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(2, 1)));
-
-        return availableMoves;
+        checkJumpMove(position, board, Vector2(-2, -1), moves);
+        checkJumpMove(position, board, Vector2(-2, 1), moves);
+        checkJumpMove(position, board, Vector2(-1, -2), moves);
+        checkJumpMove(position, board, Vector2(-1, 2), moves);
+        checkJumpMove(position, board, Vector2(1, -2), moves);
+        checkJumpMove(position, board, Vector2(1, 2), moves);
+        checkJumpMove(position, board, Vector2(2, -1), moves);
+        checkJumpMove(position, board, Vector2(2, 1), moves);
     }
 
     Pawn::Pawn(Color color)
-        : Piece(color)
+        : Piece(color, PieceType::Pawn)
     {
         m_asciiRepresentation = 'P';
     }
 
-    std::list<Move> Pawn::getAvailableMoves(Vector2 position, Board &board)
+    void Pawn::getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const
     {
-        std::list<Move> availableMoves = std::list<Move>();
-
         int invert = 1;
         if (m_color == Color::Black) invert = -1;
 
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(-1, 1 * invert), true, true)); // capture left
-        availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(1, 1 * invert), true, true));  // capture right
+        size_t firstMove = moves.size();
 
-        std::list<Move> singlePush = checkJumpMove(position, board, Vector2(0, 1 * invert), false); // push check
+        checkJumpMove(position, board, Vector2(-1, 1 * invert), moves, true, true); // capture left
+        checkJumpMove(position, board, Vector2(1, 1 * invert), moves, true, true);  // capture right
 
-        if (singlePush.size() != 0) // if can push once, check if can doublepush
+        if (checkJumpMove(position, board, Vector2(0, 1 * invert), moves, false)) // push, if can push once, check if can doublepush
         {
             if (position.m_y == (7 + (invert * -5)) / 2)
             {
-                availableMoves.splice(availableMoves.end(), checkJumpMove(position, board, Vector2(0, 2 * invert), false)); // doublepush
-            }
-
-            else if (position.m_y == (7 + (invert * 5)) / 2)
-            {
-                int lastRow = (7 + (invert * 7)) / 2;
-                availableMoves.emplace_back(board.getSquare(position), board.getSquare(Vector2(position.m_x, lastRow)), std::make_shared<Queen>(m_color)); 
-                availableMoves.emplace_back(board.getSquare(position), board.getSquare(Vector2(position.m_x, lastRow)), std::make_shared<Rook>(m_color)); 
-                availableMoves.emplace_back(board.getSquare(position), board.getSquare(Vector2(position.m_x, lastRow)), std::make_shared<Bishop>(m_color)); 
-                availableMoves.emplace_back(board.getSquare(position), board.getSquare(Vector2(position.m_x, lastRow)), std::make_shared<Knight>(m_color)); 
-                return availableMoves;
+                checkJumpMove(position, board, Vector2(0, 2 * invert), moves, false); // doublepush
             }
         }
 
-        availableMoves.splice(availableMoves.end(), singlePush); // push add
+        if (position.m_y != (7 + (invert * 5)) / 2)
+            return;
+
+        // every move from the second to last row promotes, captures included
+        size_t lastMove = moves.size();
 
-        return availableMoves;
+        for (size_t i = firstMove; i < lastMove; i++)
+        {
+            moves[i].m_promotion = Piece::get(PieceType::Queen, m_color);
+            moves.add(Move(moves[i].m_from, moves[i].m_to, Piece::get(PieceType::Rook, m_color)));
+            moves.add(Move(moves[i].m_from, moves[i].m_to, Piece::get(PieceType::Bishop, m_color)));
+            moves.add(Move(moves[i].m_from, moves[i].m_to, Piece::get(PieceType::Knight, m_color)));
+        }
     }
 }
\ No newline at end of file
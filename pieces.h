@@ -3,65 +3,79 @@
 
 #include "primitives.h"
 
-#include <list>
+#include <cstdint>
 
 namespace Chess
 {
     class Board;
     class Move;
+    class MoveList;
 
+    // Centipawns, indexed by PieceType. The king is priced so that no exchange ever gives it up.
+    constexpr int PIECE_VALUES[PIECE_TYPE_COUNT] = {20000, 900, 500, 330, 320, 100};
+
+    // Pieces are immutable flyweights: there is exactly one instance per (type, color),
+    // obtained through Piece::get() or Piece::fromCode(), and boards only store their codes.
     class Piece
     {
     protected:
         Color m_color;
+        PieceType m_type;
         char m_asciiRepresentation;
 
-        std::list<Move> checkJumpMove(Vector2 position, Board &board, Vector2 offset, bool canTake = true, bool mustTake = false);
-        std::list<Move> checkSlideMove(Vector2 position, Board &board, Vector2 offset);
+        bool checkJumpMove(Vector2 position, const Board &board, Vector2 offset, MoveList &moves, bool canTake = true, bool mustTake = false) const;
+        void checkSlideMove(Vector2 position, const Board &board, Vector2 offset, MoveList &moves) const;
 
     public:
-        Piece(Color color);
-        char getAsciiRepresentation();
-        Color getColor();
+        Piece(Color color, PieceType type);
+
+        static const Piece *get(PieceType type, Color color);
+        static const Piece *fromCode(uint8_t code);
+
+        // 0 is reserved for "no piece".
+        uint8_t getCode() const;
+        char getAsciiRepresentation() const;
+        Color getColor() const;
+        PieceType getType() const;
 
         bool operator==(const Piece &other) const;
 
-        virtual std::list<Move> getAvailableMoves(Vector2 position, Board &board) = 0;
+        virtual void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const = 0;
     };
 
     class King : public Piece
     {
     public:
         King(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
     class Queen : public Piece
     {
     public:
         Queen(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
     class Rook : public Piece
     {
     public:
         Rook(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
     class Bishop : public Piece
     {
     public:
         Bishop(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
     class Knight : public Piece
     {
     public:
         Knight(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
     class Pawn : public Piece
@@ -69,7 +83,7 @@ namespace Chess
 
     public:
         Pawn(Color color);
-        std::list<Move> getAvailableMoves(Vector2 position, Board &board) override;
+        void getAvailableMoves(Vector2 position, const Board &board, MoveList &moves) const override;
     };
 
 }
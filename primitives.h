@@ -1,12 +1,13 @@
 #ifndef PRIMITIVES_H
 #define PRIMITIVES_H
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 
 namespace Chess
 {
-
+    constexpr int BOARD_SIZE = 8;
 
     enum class Color
     {
@@ -14,6 +15,30 @@ namespace Chess
         Black
     };
 
+    enum class PieceType
+    {
+        King,
+        Queen,
+        Rook,
+        Bishop,
+        Knight,
+        Pawn
+    };
+
+    constexpr int PIECE_TYPE_COUNT = 6;
+
+    // One bit per square, bit index as in Vector2::toIndex().
+    using Bitboard = uint64_t;
+
+    // SplitMix64, a fast well mixed sequence for seeding tables and generators.
+    constexpr uint64_t splitMix(uint64_t &state)
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
     struct Vector2
     {
         int m_x;
@@ -41,11 +66,34 @@ namespace Chess
             return *this;
         }
 
-        Vector2 operator+(const Vector2 &add)
+        Vector2 operator+(const Vector2 &add) const
         {
-            (*this) += add;
+            Vector2 result = *this;
+            result += add;
 
-            return *this;
+            return result;
+        }
+
+        bool operator==(const Vector2 &other) const
+        {
+            return m_x == other.m_x && m_y == other.m_y;
+        }
+
+        // Index into a flat board array, a1 = 0, b1 = 1, ..., h8 = 63.
+        int toIndex() const
+        {
+            return m_y * BOARD_SIZE + m_x;
+        }
+
+        static Vector2 fromIndex(int index)
+        {
+            return Vector2(index % BOARD_SIZE, index / BOARD_SIZE);
+        }
+
+        // "e4" style square name.
+        std::string toAlgebraic() const
+        {
+            return std::string{(char)('a' + m_x), (char)('1' + m_y)};
         }
 
         std::string toString()
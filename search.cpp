@@ -0,0 +1,237 @@
+#include "search.h"
+
+#include "attacks.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Chess
+{
+    namespace
+    {
+        Color opponentOf(Color color)
+        {
+            return color == Color::White ? Color::Black : Color::White;
+        }
+
+        // Small positional terms on top of material: advanced pawns and centralised minor pieces.
+        int positionalBonus(PieceType type, Color color, Vector2 position)
+        {
+            int rank = color == Color::White ? position.m_y : BOARD_SIZE - 1 - position.m_y;
+            int centerDistance = std::max(std::abs(2 * position.m_x - 7), std::abs(2 * position.m_y - 7)) / 2;
+
+            switch (type)
+            {
+            case PieceType::Pawn:
+                return 5 * (rank - 1);
+            case PieceType::Knight:
+            case PieceType::Bishop:
+                return 10 - 5 * centerDistance;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    Search::Search()
+        : m_nodes(0), m_cutoffs(0), m_firstMoveCutoffs(0)
+    {
+    }
+
+    SearchResult Search::run(const Board &board, Color color, int depth)
+    {
+        m_nodes = 0;
+        m_cutoffs = 0;
+        m_firstMoveCutoffs = 0;
+        m_ordering.decay();
+
+        SearchResult result;
+        result.m_score = -MATE_SCORE;
+
+        MoveList moves = board.getLegalMovesFor(color);
+
+        if (moves.size() == 0)
+        {
+            result.m_score = board.isInCheck(color) ? -MATE_SCORE : 0;
+        }
+
+        for (int currentDepth = 1; currentDepth <= depth && moves.size() != 0; currentDepth++)
+        {
+            result.m_score = searchRoot(board, color, currentDepth, moves, result.m_bestMove);
+        }
+
+        result.m_nodes = m_nodes;
+        result.m_cutoffs = m_cutoffs;
+        result.m_firstMoveCutoffs = m_firstMoveCutoffs;
+        result.m_firstMoveCutoffPercent = m_cutoffs == 0 ? 0.0 : 100.0 * m_firstMoveCutoffs / m_cutoffs;
+        return result;
+    }
+
+    int Search::searchRoot(const Board &board, Color color, int depth, MoveList &moves, Move &bestMove)
+    {
+        MoveScores scores;
+        m_ordering.scoreMoves(board, color, moves, 0, nullptr, scores);
+
+        // the best move of the previous iteration goes first
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            if (moves[i] == bestMove)
+                scores[i] = MATE_SCORE * 100;
+        }
+
+        int alpha = -MATE_SCORE - 1;
+
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            const Move &move = MoveOrdering::pickNext(moves, scores, i);
+
+            Board after = board;
+            Move played = move;
+            after.makeMove(played);
+
+            int score = -negamax(after, opponentOf(color), depth - 1, -MATE_SCORE - 1, -alpha, 1, move);
+
+            if (score > alpha)
+            {
+                alpha = score;
+                bestMove = move;
+            }
+        }
+
+        return alpha;
+    }
+
+    int Search::negamax(const Board &board, Color color, int depth, int alpha, int beta, int ply, const Move &previous)
+    {
+        if (depth <= 0 || ply >= MAX_PLY)
+            return quiescence(board, color, alpha, beta, ply);
+
+        m_nodes++;
+
+        MoveList moves = board.getAvailableMovesFor(color);
+        MoveScores scores;
+        m_ordering.scoreMoves(board, color, moves, ply, &previous, scores);
+
+        int legalMoves = 0;
+        SearchedMoves searched;
+
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            const Move &move = MoveOrdering::pickNext(moves, scores, i);
+            bool quiet = board.getSquare(move.m_to).getPiece() == nullptr && move.m_promotion == nullptr;
+
+            Board after = board;
+            Move played = move;
+            after.makeMove(played);
+
+            if (after.isInCheck(color))
+                continue;
+
+            legalMoves++;
+            searched.set(i);
+
+            int score = -negamax(after, opponentOf(color), depth - 1, -beta, -alpha, ply + 1, move);
+
+            if (score >= beta)
+            {
+                m_cutoffs++;
+
+                if (legalMoves == 1)
+                    m_firstMoveCutoffs++;
+
+                if (quiet)
+                    m_ordering.recordCutoff(board, color, moves, searched, i, depth, ply, &previous);
+
+                return score;
+            }
+
+            if (score > alpha)
+                alpha = score;
+        }
+
+        if (legalMoves == 0)
+            return board.isInCheck(color) ? -MATE_SCORE + ply : 0;
+
+        return alpha;
+    }
+
+    int Search::quiescence(const Board &board, Color color, int alpha, int beta, int ply)
+    {
+        m_nodes++;
+
+        int standPat = evaluate(board, color);
+
+        if (standPat >= beta || ply >= MAX_PLY)
+            return standPat;
+
+        if (standPat > alpha)
+            alpha = standPat;
+
+        MoveList captures = board.getCapturesFor(color);
+        MoveScores scores;
+        MoveOrdering::scoreCaptures(board, captures, scores);
+
+        for (size_t i = 0; i < captures.size(); i++)
+        {
+            const Move &move = MoveOrdering::pickNext(captures, scores, i);
+
+            int gain = PIECE_VALUES[(int)board.getSquare(move.m_to).getPiece()->getType()];
+
+            if (move.m_promotion != nullptr)
+            {
+                // underpromotions never beat the queen in a capture sequence
+                if (move.m_promotion->getType() != PieceType::Queen)
+                    continue;
+
+                gain += PIECE_VALUES[(int)PieceType::Queen] - PIECE_VALUES[(int)PieceType::Pawn];
+            }
+
+            // delta pruning, even winning the piece outright does not reach alpha
+            if (standPat + gain + DELTA_MARGIN <= alpha)
+                continue;
+
+            // losing captures are not worth searching
+            if (board.staticExchange(move) < 0)
+                continue;
+
+            Board after = board;
+            Move played = move;
+            after.makeMove(played);
+
+            if (after.isInCheck(color))
+                continue;
+
+            int score = -quiescence(after, opponentOf(color), -beta, -alpha, ply + 1);
+
+            if (score >= beta)
+                return score;
+
+            if (score > alpha)
+                alpha = score;
+        }
+
+        return alpha;
+    }
+
+    int Search::evaluate(const Board &board, Color color)
+    {
+        int score = 0;
+
+        for (int type = 1; type < PIECE_TYPE_COUNT; type++) // kings are always on the board
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                Bitboard pieces = board.getPieces((PieceType)type, (Color)side);
+                int sign = (Color)side == color ? 1 : -1;
+
+                while (pieces != 0)
+                {
+                    Vector2 position = Vector2::fromIndex(Attacks::popLsb(pieces));
+                    score += sign * (PIECE_VALUES[type] + positionalBonus((PieceType)type, (Color)side, position));
+                }
+            }
+        }
+
+        return score;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "board.h"
+#include "move.h"
+#include "moveorder.h"
+
+#include <cstdint>
+
+namespace Chess
+{
+    constexpr int MATE_SCORE = 100000;
+    constexpr int MAX_PLY = 128;
+
+    // Captures that cannot lift the score to alpha even after winning this much extra are skipped.
+    constexpr int DELTA_MARGIN = 200;
+
+    struct SearchResult
+    {
+        Move m_bestMove;
+        int m_score;
+        uint64_t m_nodes;
+
+        // Share of beta cutoffs produced by the first move searched, a measure of move ordering quality.
+        uint64_t m_cutoffs;
+        uint64_t m_firstMoveCutoffs;
+        double m_firstMoveCutoffPercent;
+    };
+
+    // Iterative deepening alpha-beta search, finished by a capture-only quiescence search.
+    // A Search keeps its move ordering tables between runs, use one instance per thread.
+    class Search
+    {
+        MoveOrdering m_ordering;
+
+        uint64_t m_nodes;
+        uint64_t m_cutoffs;
+        uint64_t m_firstMoveCutoffs;
+
+        int searchRoot(const Board &board, Color color, int depth, MoveList &moves, Move &bestMove);
+        int negamax(const Board &board, Color color, int depth, int alpha, int beta, int ply, const Move &previous);
+        int quiescence(const Board &board, Color color, int alpha, int beta, int ply);
+
+    public:
+        Search();
+
+        SearchResult run(const Board &board, Color color, int depth);
+
+        // Static score of the position from the point of view of color.
+        static int evaluate(const Board &board, Color color);
+    };
+}
+
+#endif
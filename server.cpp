@@ -0,0 +1,375 @@
+#include "server.h"
+
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Chess
+{
+    namespace
+    {
+        constexpr int MAX_EVENTS = 64;
+        constexpr size_t READ_SIZE = 4096;
+        // a client that sends this much without a newline is not speaking the protocol
+        constexpr size_t MAX_LINE = 1024;
+        // past this much unsent output a connection is neither read from nor served until the client catches up
+        constexpr size_t MAX_OUTPUT = 64 * 1024;
+        // how long a worker out of descriptors waits before it listens for new connections again
+        constexpr int ACCEPT_RETRY_MS = 100;
+
+        struct Connection
+        {
+            std::string m_input;
+            std::string m_output;
+            uint32_t m_events = EPOLLIN;
+        };
+
+        std::vector<std::string> split(const std::string &line)
+        {
+            std::vector<std::string> words;
+            size_t start = 0;
+
+            while (start < line.size())
+            {
+                size_t end = line.find(' ', start);
+                if (end == std::string::npos) end = line.size();
+                if (end != start) words.push_back(line.substr(start, end - start));
+                start = end + 1;
+            }
+
+            return words;
+        }
+
+        bool watchListenSocket(int epoll, int listenSocket)
+        {
+            // only one worker is woken per incoming connection
+            epoll_event listenEvent = epoll_event();
+            listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+            listenEvent.data.fd = listenSocket;
+            return epoll_ctl(epoll, EPOLL_CTL_ADD, listenSocket, &listenEvent) == 0;
+        }
+
+        bool parseId(const std::string &text, uint64_t &id)
+        {
+            if (text.empty() || text.size() > 19) return false;
+
+            id = 0;
+
+            for (char c : text)
+            {
+                if (c < '0' || c > '9') return false;
+                id = id * 10 + (c - '0');
+            }
+
+            return true;
+        }
+    }
+
+    Server::Server(SessionManager &sessions, const std::string &socketPath, size_t threadCount)
+        : m_sessions(sessions), m_socketPath(socketPath), m_threadCount(threadCount == 0 ? 1 : threadCount), m_listenSocket(-1)
+    {
+    }
+
+    Server::~Server()
+    {
+        if (m_listenSocket >= 0)
+        {
+            close(m_listenSocket);
+            unlink(m_socketPath.c_str());
+        }
+    }
+
+    bool Server::run()
+    {
+        sockaddr_un address = sockaddr_un();
+        address.sun_family = AF_UNIX;
+
+        if (m_socketPath.size() >= sizeof(address.sun_path))
+        {
+            std::cerr << "Socket path too long: " << m_socketPath << std::endl;
+            return false;
+        }
+
+        std::strcpy(address.sun_path, m_socketPath.c_str());
+        unlink(m_socketPath.c_str());
+
+        m_listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+        if (m_listenSocket < 0 || bind(m_listenSocket, (sockaddr *)&address, sizeof(address)) != 0 || listen(m_listenSocket, SOMAXCONN) != 0)
+        {
+            std::cerr << "Cannot listen on " << m_socketPath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        std::vector<int> epolls;
+
+        for (size_t i = 0; i < m_threadCount; i++)
+        {
+            int epoll = epoll_create1(0);
+
+            if (epoll < 0 || !watchListenSocket(epoll, m_listenSocket))
+            {
+                std::cerr << "Cannot set up epoll: " << std::strerror(errno) << std::endl;
+
+                if (epoll >= 0) close(epoll);
+                for (int created : epolls) close(created);
+
+                return false;
+            }
+
+            epolls.push_back(epoll);
+        }
+
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < m_threadCount; i++)
+        {
+            workers.emplace_back(&Server::work, this, i, epolls[i]);
+        }
+
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+
+        return true;
+    }
+
+    void Server::work(size_t worker, int epoll)
+    {
+        // Out of descriptors, a pending connection keeps the listen socket readable and the worker would spin.
+        // The spare is given up to accept and drop such a connection, and when there is none the worker
+        // stops listening for ACCEPT_RETRY_MS.
+        int spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        bool listening = true;
+
+        std::unordered_map<int, Connection> connections;
+        epoll_event events[MAX_EVENTS];
+        char buffer[READ_SIZE];
+
+        while (true)
+        {
+            int count = epoll_wait(epoll, events, MAX_EVENTS, listening ? -1 : ACCEPT_RETRY_MS);
+
+            if (count < 0 && errno != EINTR)
+                break;
+
+            if (!listening)
+                listening = watchListenSocket(epoll, m_listenSocket);
+
+            for (int i = 0; i < count; i++)
+            {
+                int fd = events[i].data.fd;
+
+                if (fd == m_listenSocket)
+                {
+                    while (listening)
+                    {
+                        int client = accept4(m_listenSocket, nullptr, nullptr, SOCK_NONBLOCK);
+
+                        if (client < 0 && (errno == EINTR || errno == ECONNABORTED))
+                            continue;
+
+                        // accept4 reports EMFILE before it looks at the queue, only a retry with the spare freed tells
+                        // whether a connection is waiting
+                        if (client < 0 && (errno == EMFILE || errno == ENFILE) && spare >= 0)
+                        {
+                            close(spare);
+                            client = accept4(m_listenSocket, nullptr, nullptr, 0);
+                            bool dropped = client >= 0;
+                            if (dropped) close(client);
+                            spare = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+                            if (dropped)
+                                continue;
+
+                            break;
+                        }
+
+                        if (client < 0 && (errno == EMFILE || errno == ENFILE) && epoll_ctl(epoll, EPOLL_CTL_DEL, m_listenSocket, nullptr) == 0)
+                            listening = false;
+
+                        if (client < 0)
+                            break;
+
+                        epoll_event clientEvent = epoll_event();
+                        clientEvent.events = EPOLLIN;
+                        clientEvent.data.fd = client;
+
+                        if (epoll_ctl(epoll, EPOLL_CTL_ADD, client, &clientEvent) != 0)
+                        {
+                            close(client);
+                            continue;
+                        }
+
+                        connections[client] = Connection();
+                    }
+
+                    continue;
+                }
+
+                Connection &connection = connections[fd];
+                bool closed = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+
+                while (!closed)
+                {
+                    size_t start = 0;
+                    size_t end;
+
+                    while (connection.m_output.size() < MAX_OUTPUT && (end = connection.m_input.find('\n', start)) != std::string::npos)
+                    {
+                        std::string line = connection.m_input.substr(start, end - start);
+                        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+                        connection.m_output += handle(line, worker);
+                        connection.m_output += '\n';
+                        start = end + 1;
+                    }
+
+                    connection.m_input.erase(0, start);
+
+                    // below the output limit every complete line has been handled, what is left is one unfinished line
+                    if (connection.m_output.size() < MAX_OUTPUT && connection.m_input.size() > MAX_LINE)
+                        closed = true;
+
+                    while (!closed && !connection.m_output.empty())
+                    {
+                        ssize_t sent = send(fd, connection.m_output.data(), connection.m_output.size(), MSG_NOSIGNAL);
+
+                        if (sent > 0)
+                        {
+                            connection.m_output.erase(0, sent);
+                            continue;
+                        }
+
+                        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                            closed = true;
+
+                        if (sent < 0 && errno == EINTR)
+                            continue;
+
+                        break;
+                    }
+
+                    // stop reading until the client drains its replies
+                    if (closed || connection.m_output.size() >= MAX_OUTPUT)
+                        break;
+
+                    // lines held back while the output was full can be served now
+                    if (connection.m_input.find('\n') != std::string::npos)
+                        continue;
+
+                    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+
+                    if (received > 0)
+                    {
+                        connection.m_input.append(buffer, received);
+                        continue;
+                    }
+
+                    if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                        closed = true;
+
+                    if (received < 0 && errno == EINTR)
+                        continue;
+
+                    break;
+                }
+
+                // wait for the socket to drain before sending the rest, and only read while the output is below its limit
+                uint32_t wanted = (connection.m_output.size() < MAX_OUTPUT ? EPOLLIN : 0) | (!connection.m_output.empty() ? EPOLLOUT : 0);
+
+                if (!closed && wanted != connection.m_events)
+                {
+                    epoll_event clientEvent = epoll_event();
+                    clientEvent.events = wanted;
+                    clientEvent.data.fd = fd;
+
+                    if (epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &clientEvent) != 0)
+                        closed = true;
+
+                    connection.m_events = wanted;
+                }
+
+                // closing the descriptor also takes it out of the epoll set
+                if (closed)
+                {
+                    close(fd);
+                    connections.erase(fd);
+                }
+            }
+        }
+
+        for (auto &connection : connections)
+        {
+            close(connection.first);
+        }
+
+        if (spare >= 0) close(spare);
+        close(epoll);
+    }
+
+    std::string Server::handle(const std::string &line, size_t worker)
+    {
+        std::vector<std::string> words = split(line);
+
+        if (words.empty())
+            return "error empty request";
+
+        const std::string &command = words[0];
+
+        if (command == "new")
+        {
+            if (words.size() != 1) return "error wrong number of arguments";
+            return "ok " + std::to_string(m_sessions.create(worker));
+        }
+
+        // every other command takes a session id first
+        size_t argumentCount;
+
+        if (command == "move") argumentCount = 2;
+        else if (command == "legal-moves" || command == "fen" || command == "close") argumentCount = 1;
+        else return "error unknown command";
+
+        uint64_t id;
+
+        if (words.size() < 2 || !parseId(words[1], id))
+            return "error expected a session id";
+
+        if (words.size() != 1 + argumentCount)
+            return "error wrong number of arguments";
+
+        if (command == "move")
+        {
+            bool legal;
+            if (!m_sessions.tryToMakeMove(id, words[2], legal)) return "error unknown session";
+            return legal ? "ok" : "illegal";
+        }
+
+        if (command == "legal-moves")
+        {
+            std::string moves;
+            if (!m_sessions.getLegalMoves(id, moves)) return "error unknown session";
+            return moves.empty() ? "ok" : "ok " + moves;
+        }
+
+        if (command == "fen")
+        {
+            std::string fen;
+            if (!m_sessions.getFen(id, fen)) return "error unknown session";
+            return "ok " + fen;
+        }
+
+        if (!m_sessions.close(id)) return "error unknown session";
+        return "ok";
+    }
+}
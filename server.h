@@ -0,0 +1,38 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "session.h"
+
+#include <string>
+
+namespace Chess
+{
+    // Serves a SessionManager over a Unix domain socket, one request and one response per line:
+    //   new                 -> ok <id>
+    //   move <id> <e2e4>    -> ok | illegal
+    //   legal-moves <id>    -> ok <move> <move> ...
+    //   fen <id>            -> ok <fen>
+    //   close <id>          -> ok
+    // Failures answer "error <reason>".
+    // A fixed pool of workers share the listening socket, each serving its own connections
+    // and creating new sessions in its own shard.
+    class Server
+    {
+        SessionManager &m_sessions;
+        std::string m_socketPath;
+        size_t m_threadCount;
+        int m_listenSocket;
+
+        void work(size_t worker, int epoll);
+        std::string handle(const std::string &line, size_t worker);
+
+    public:
+        Server(SessionManager &sessions, const std::string &socketPath, size_t threadCount);
+        ~Server();
+
+        // Blocks while serving, returns false if the socket could not be set up.
+        bool run();
+    };
+}
+
+#endif
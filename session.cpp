@@ -0,0 +1,207 @@
+#include "session.h"
+
+namespace Chess
+{
+    namespace
+    {
+        uint64_t slotOf(uint64_t id)
+        {
+            return id & (((uint64_t)1 << SESSION_SLOT_BITS) - 1);
+        }
+    }
+
+    Session::Session()
+        : m_toMove(Color::White), m_halfmoveClock(0), m_fullmoveNumber(1), m_generation(0), m_active(false)
+    {
+    }
+
+    bool Session::newGame()
+    {
+        m_board.initDefault();
+        m_toMove = Color::White;
+        m_halfmoveClock = 0;
+        m_fullmoveNumber = 1;
+        m_active = true;
+        return true;
+    }
+
+    bool Session::close()
+    {
+        m_active = false;
+        m_generation = (m_generation + 1) & SESSION_GENERATION_MASK;
+        return true;
+    }
+
+    bool Session::isActive() const
+    {
+        return m_active;
+    }
+
+    uint32_t Session::getGeneration() const
+    {
+        return m_generation;
+    }
+
+    bool Session::tryToMakeMove(const Move &move)
+    {
+        if (!m_board.isLegal(move, m_toMove))
+            return false;
+
+        bool pawnMove = m_board.getSquare(move.m_from).getPiece()->getType() == PieceType::Pawn;
+
+        Move played = move;
+        m_board.makeMove(played);
+
+        if (pawnMove || played.m_captured != nullptr) m_halfmoveClock = 0;
+        else m_halfmoveClock++;
+
+        if (m_toMove == Color::Black) m_fullmoveNumber++;
+
+        if (m_toMove == Color::White) m_toMove = Color::Black;
+        else m_toMove = Color::White;
+
+        return true;
+    }
+
+    MoveList Session::getLegalMoves() const
+    {
+        return m_board.getLegalMovesFor(m_toMove);
+    }
+
+    std::string Session::getFen() const
+    {
+        return m_board.toFen(m_toMove, m_halfmoveClock, m_fullmoveNumber);
+    }
+
+    Color Session::whoIsOnTurn() const
+    {
+        return m_toMove;
+    }
+
+    SessionManager::SessionManager(size_t shardCount)
+    {
+        if (shardCount == 0) shardCount = 1;
+
+        for (size_t i = 0; i < shardCount; i++)
+        {
+            m_shards.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    size_t SessionManager::getShardCount() const
+    {
+        return m_shards.size();
+    }
+
+    SessionManager::Shard &SessionManager::getShard(uint64_t id)
+    {
+        return *m_shards[slotOf(id) % m_shards.size()];
+    }
+
+    Session *SessionManager::find(Shard &shard, uint64_t id)
+    {
+        uint64_t index = slotOf(id) / m_shards.size();
+
+        if (index >= shard.m_size)
+            return nullptr;
+
+        Session *session = &shard.m_chunks[index / SESSION_CHUNK][index % SESSION_CHUNK];
+
+        if (!session->isActive() || session->getGeneration() != id >> SESSION_SLOT_BITS)
+            return nullptr;
+
+        return session;
+    }
+
+    uint64_t SessionManager::create(size_t shardIndex)
+    {
+        shardIndex %= m_shards.size();
+        Shard &shard = *m_shards[shardIndex];
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+        uint64_t index;
+
+        if (!shard.m_free.empty())
+        {
+            index = shard.m_free.back();
+            shard.m_free.pop_back();
+        }
+        else
+        {
+            index = shard.m_size++;
+
+            if (index % SESSION_CHUNK == 0)
+                shard.m_chunks.push_back(std::make_unique<Session[]>(SESSION_CHUNK));
+        }
+
+        Session &session = shard.m_chunks[index / SESSION_CHUNK][index % SESSION_CHUNK];
+        session.newGame();
+
+        return (uint64_t)session.getGeneration() << SESSION_SLOT_BITS | (index * m_shards.size() + shardIndex);
+    }
+
+    bool SessionManager::close(uint64_t id)
+    {
+        Shard &shard = getShard(id);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+        Session *session = find(shard, id);
+
+        if (session == nullptr)
+            return false;
+
+        session->close();
+        shard.m_free.push_back(slotOf(id) / m_shards.size());
+        return true;
+    }
+
+    bool SessionManager::tryToMakeMove(uint64_t id, const std::string &text, bool &legal)
+    {
+        Shard &shard = getShard(id);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+        Session *session = find(shard, id);
+
+        if (session == nullptr)
+            return false;
+
+        Move move;
+        legal = Move::fromString(text, session->whoIsOnTurn(), move) && session->tryToMakeMove(move);
+        return true;
+    }
+
+    bool SessionManager::getLegalMoves(uint64_t id, std::string &moves)
+    {
+        Shard &shard = getShard(id);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+        Session *session = find(shard, id);
+
+        if (session == nullptr)
+            return false;
+
+        moves.clear();
+
+        for (const Move &move : session->getLegalMoves())
+        {
+            if (!moves.empty()) moves += ' ';
+            moves += move.toString();
+        }
+
+        return true;
+    }
+
+    bool SessionManager::getFen(uint64_t id, std::string &fen)
+    {
+        Shard &shard = getShard(id);
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+        Session *session = find(shard, id);
+
+        if (session == nullptr)
+            return false;
+
+        fen = session->getFen();
+        return true;
+    }
+}
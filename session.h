@@ -0,0 +1,87 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "board.h"
+#include "move.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Chess
+{
+    // The state of one hosted game. Unlike Game it keeps no history,
+    // so an idle session is a plain value with nothing on the heap.
+    class Session
+    {
+        Board m_board;
+        Color m_toMove;
+        uint16_t m_halfmoveClock;
+        uint16_t m_fullmoveNumber;
+        // bumped on every close, part of the session id
+        uint32_t m_generation;
+        bool m_active;
+
+    public:
+        Session();
+
+        bool newGame();
+        bool close();
+        bool isActive() const;
+        uint32_t getGeneration() const;
+
+        bool tryToMakeMove(const Move &move);
+        MoveList getLegalMoves() const;
+        std::string getFen() const;
+
+        Color whoIsOnTurn() const;
+    };
+
+    constexpr size_t SESSION_BUDGET = 200;
+    static_assert(sizeof(Session) <= SESSION_BUDGET, "an idle session must stay compact");
+
+    // Sessions are allocated in fixed chunks, so storage never moves and the slack is at most one chunk per shard.
+    constexpr size_t SESSION_CHUNK = 4096;
+
+    // A session id holds its slot, index * shard count + shard, in the low SESSION_SLOT_BITS bits and the
+    // generation of that slot above them. Slots are reused, the generation keeps a stale id from reaching
+    // the next game in the same slot.
+    constexpr int SESSION_SLOT_BITS = 32;
+    constexpr uint32_t SESSION_GENERATION_MASK = 0xffffff;
+
+    // Sessions are split into shards, each with its own lock and storage.
+    // Session ids encode their shard, so a lookup only ever touches one shard.
+    class SessionManager
+    {
+        struct Shard
+        {
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<Session[]>> m_chunks;
+            uint64_t m_size = 0;
+            std::vector<uint64_t> m_free;
+        };
+
+        std::vector<std::unique_ptr<Shard>> m_shards;
+
+        Shard &getShard(uint64_t id);
+        Session *find(Shard &shard, uint64_t id);
+
+    public:
+        SessionManager(size_t shardCount);
+
+        size_t getShardCount() const;
+
+        // Creates the session in the given shard, callers pass their worker index to keep sessions local.
+        uint64_t create(size_t shard);
+        bool close(uint64_t id);
+
+        // Each returns false if there is no such session.
+        bool tryToMakeMove(uint64_t id, const std::string &move, bool &legal);
+        bool getLegalMoves(uint64_t id, std::string &moves);
+        bool getFen(uint64_t id, std::string &fen);
+    };
+}
+
+#endif
@@ -0,0 +1,349 @@
+#include "snapshot.h"
+
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Chess
+{
+    namespace
+    {
+        size_t paddedHistoryLength(uint32_t historyLength)
+        {
+            return (historyLength + 1) & ~(size_t)1;
+        }
+
+        // Returns where the complete records at the start of data end, a torn or foreign record ends the scan.
+        size_t scanRecords(const uint8_t *data, size_t size, std::vector<const SnapshotRecord *> *records)
+        {
+            size_t offset = 0;
+
+            while (offset + sizeof(SnapshotRecord) <= size)
+            {
+                const SnapshotRecord *record = reinterpret_cast<const SnapshotRecord *>(data + offset);
+
+                if (record->m_magic != SNAPSHOT_MAGIC || record->m_version != SNAPSHOT_VERSION || offset + record->getSize() > size)
+                    break;
+
+                if (records != nullptr)
+                    records->push_back(record);
+
+                offset += record->getSize();
+            }
+
+            return offset;
+        }
+
+        // True if the bytes from offset on are what an interrupted append leaves: a partial header, or
+        // a valid header whose history runs past the end. Anything else is corruption, not a torn tail.
+        bool isTornTail(const uint8_t *data, size_t size, size_t offset)
+        {
+            if (size - offset < sizeof(SnapshotRecord))
+                return true;
+
+            const SnapshotRecord *record = reinterpret_cast<const SnapshotRecord *>(data + offset);
+
+            return record->m_magic == SNAPSHOT_MAGIC && record->m_version == SNAPSHOT_VERSION && offset + record->getSize() > size;
+        }
+
+        // Every 4 bit code to its piece, codes without one decode as nullptr just like Piece::fromCode().
+        std::array<const Piece *, 16> makePieceTable()
+        {
+            std::array<const Piece *, 16> pieces{};
+
+            for (uint8_t code = 1; code <= 2 * PIECE_TYPE_COUNT; code++)
+            {
+                pieces[code] = Piece::fromCode(code);
+            }
+
+            return pieces;
+        }
+
+        const std::array<const Piece *, 16> PIECES = makePieceTable();
+
+        // Kept branch free and visible to the restore loop, history decoding dominates restoring long games.
+        void decodeMove(uint32_t packed, Move &move)
+        {
+            move.m_from = Vector2(packed & 7, (packed >> 3) & 7);
+            move.m_to = Vector2((packed >> 6) & 7, (packed >> 9) & 7);
+            move.m_promotion = PIECES[(packed >> 12) & 15];
+            move.m_captured = PIECES[(packed >> 16) & 15];
+        }
+    }
+
+    size_t SnapshotRecord::getSize() const
+    {
+        return sizeof(SnapshotRecord) + paddedHistoryLength(m_historyLength) * sizeof(uint32_t);
+    }
+
+    const uint32_t *SnapshotRecord::getHistory() const
+    {
+        return reinterpret_cast<const uint32_t *>(this + 1);
+    }
+
+    namespace Snapshot
+    {
+        uint32_t packMove(const Move &move)
+        {
+            uint32_t promotion = move.m_promotion != nullptr ? move.m_promotion->getCode() : 0;
+            uint32_t captured = move.m_captured != nullptr ? move.m_captured->getCode() : 0;
+
+            return move.m_from.toIndex() | move.m_to.toIndex() << 6 | promotion << 12 | captured << 16;
+        }
+
+        Move unpackMove(uint32_t packed)
+        {
+            Move move;
+            decodeMove(packed, move);
+
+            return move;
+        }
+
+        void append(const Game &game, std::vector<uint8_t> &buffer)
+        {
+            const Board &board = game.getBoard();
+            const std::vector<Move> &history = game.getHistory();
+
+            SnapshotRecord record = SnapshotRecord();
+            record.m_magic = SNAPSHOT_MAGIC;
+            record.m_version = SNAPSHOT_VERSION;
+            record.m_toMove = (uint8_t)game.whoIsOnTurn();
+            record.m_halfmoveClock = game.getHalfmoveClock();
+            record.m_fullmoveNumber = game.getFullmoveNumber();
+            record.m_historyLength = history.size();
+
+            for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+            {
+                record.m_squares[i / 2] |= board.getSquare(Vector2::fromIndex(i)).getCode() << (4 * (i % 2));
+            }
+
+            size_t offset = buffer.size();
+            buffer.resize(offset + record.getSize());
+            std::memcpy(buffer.data() + offset, &record, sizeof(record));
+
+            uint32_t *packedHistory = reinterpret_cast<uint32_t *>(buffer.data() + offset + sizeof(record));
+
+            for (size_t i = 0; i < paddedHistoryLength(record.m_historyLength); i++)
+            {
+                packedHistory[i] = i < history.size() ? packMove(history[i]) : 0;
+            }
+        }
+
+        Board unpackBoard(const SnapshotRecord &record)
+        {
+            uint8_t codes[BOARD_SIZE * BOARD_SIZE];
+
+            for (int i = 0; i < BOARD_SIZE * BOARD_SIZE / 2; i++)
+            {
+                codes[2 * i] = record.m_squares[i] & 15;
+                codes[2 * i + 1] = record.m_squares[i] >> 4;
+            }
+
+            // a corrupted square reads as empty rather than as a piece that does not exist
+            for (uint8_t &code : codes)
+            {
+                if (code > 2 * PIECE_TYPE_COUNT) code = 0;
+            }
+
+            Board board;
+            board.setPieceCodes(codes);
+
+            return board;
+        }
+
+        bool restore(const SnapshotRecord &record, Game &game)
+        {
+            if (record.m_magic != SNAPSHOT_MAGIC || record.m_version != SNAPSHOT_VERSION || record.m_toMove > 1)
+                return false;
+
+            game.restore(unpackBoard(record), (Color)record.m_toMove, record.m_halfmoveClock, record.m_fullmoveNumber);
+
+            // decoded straight into the history buffer of the game
+            const uint32_t *packedHistory = record.getHistory();
+            Move move;
+
+            for (uint32_t i = 0; i < record.m_historyLength; i++)
+            {
+                decodeMove(packedHistory[i], move);
+                game.appendHistory(move);
+            }
+
+            return true;
+        }
+    }
+
+    SnapshotWriter::SnapshotWriter()
+        : m_file(nullptr)
+    {
+    }
+
+    SnapshotWriter::~SnapshotWriter()
+    {
+        if (m_file != nullptr)
+        {
+            flush();
+            std::fclose(m_file);
+        }
+    }
+
+    bool SnapshotWriter::open(const std::string &path)
+    {
+        if (m_file != nullptr)
+        {
+            flush();
+            std::fclose(m_file);
+        }
+
+        m_file = nullptr;
+
+        int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+
+        if (file < 0)
+            return false;
+
+        // a crash can leave a torn record at the end, cut it off so new records stay reachable
+        struct stat status;
+        size_t validSize = 0;
+        bool torn = false;
+
+        if (fstat(file, &status) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        if (status.st_size != 0)
+        {
+            void *data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                return false;
+            }
+
+            validSize = scanRecords(static_cast<const uint8_t *>(data), status.st_size, nullptr);
+            torn = (off_t)validSize != status.st_size && isTornTail(static_cast<const uint8_t *>(data), status.st_size, validSize);
+            munmap(data, status.st_size);
+        }
+
+        // records after a corrupted one would be unreachable, refuse to append rather than cut them off
+        if ((off_t)validSize != status.st_size && (!torn || ftruncate(file, validSize) != 0))
+        {
+            ::close(file);
+            return false;
+        }
+
+        m_file = fdopen(file, "ab");
+
+        if (m_file == nullptr)
+            ::close(file);
+
+        return m_file != nullptr;
+    }
+
+    bool SnapshotWriter::append(const Game &game)
+    {
+        if (m_file == nullptr)
+            return false;
+
+        Snapshot::append(game, m_buffer);
+
+        if (m_buffer.size() >= SNAPSHOT_FLUSH_SIZE)
+            return flush();
+
+        return true;
+    }
+
+    bool SnapshotWriter::flush()
+    {
+        if (m_file == nullptr)
+            return false;
+
+        bool written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+        m_buffer.clear();
+
+        return written && std::fflush(m_file) == 0;
+    }
+
+    SnapshotFile::SnapshotFile()
+        : m_data(nullptr), m_size(0)
+    {
+    }
+
+    SnapshotFile::~SnapshotFile()
+    {
+        close();
+    }
+
+    void SnapshotFile::close()
+    {
+        if (m_data != nullptr)
+            munmap(const_cast<uint8_t *>(m_data), m_size);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_records.clear();
+    }
+
+    bool SnapshotFile::open(const std::string &path)
+    {
+        close();
+
+        int file = ::open(path.c_str(), O_RDONLY);
+
+        if (file < 0)
+            return false;
+
+        struct stat status;
+
+        if (fstat(file, &status) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        m_size = status.st_size;
+
+        if (m_size != 0)
+        {
+            void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                m_size = 0;
+                return false;
+            }
+
+            m_data = static_cast<const uint8_t *>(data);
+        }
+
+        ::close(file);
+
+        scanRecords(m_data, m_size, &m_records);
+
+        return true;
+    }
+
+    size_t SnapshotFile::size() const
+    {
+        return m_records.size();
+    }
+
+    const SnapshotRecord &SnapshotFile::operator[](size_t index) const
+    {
+        return *m_records[index];
+    }
+
+    bool SnapshotFile::restore(size_t index, Game &game) const
+    {
+        if (index >= m_records.size())
+            return false;
+
+        return Snapshot::restore(*m_records[index], game);
+    }
+}
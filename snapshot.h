@@ -0,0 +1,95 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "board.h"
+#include "game.h"
+#include "move.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Chess
+{
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x4e534843; // "CHSN" on disk
+    constexpr uint16_t SNAPSHOT_VERSION = 1;
+    // Buffered records are written out once they reach this size.
+    constexpr size_t SNAPSHOT_FLUSH_SIZE = 1 << 20;
+
+    // Fixed layout record for one game, in native (little-endian) byte order. It is followed by
+    // m_historyLength packed moves, padded so every record starts 8 byte aligned and can be
+    // read in place from a mapped file.
+    struct SnapshotRecord
+    {
+        uint32_t m_magic;
+        uint16_t m_version;
+        uint8_t m_toMove;
+        uint8_t m_rights; // castling rights, always 0 as the rules have no castling
+        uint16_t m_halfmoveClock;
+        uint16_t m_fullmoveNumber;
+        uint32_t m_historyLength;
+        uint8_t m_squares[BOARD_SIZE * BOARD_SIZE / 2]; // piece codes, a1 in the low nibble of the first byte
+
+        size_t getSize() const;
+        const uint32_t *getHistory() const;
+    };
+
+    static_assert(sizeof(SnapshotRecord) == 48, "the snapshot record layout is part of the file format");
+
+    namespace Snapshot
+    {
+        // from | to << 6 | promotion code << 12 | captured code << 16
+        uint32_t packMove(const Move &move);
+        Move unpackMove(uint32_t packed);
+
+        void append(const Game &game, std::vector<uint8_t> &buffer);
+        Board unpackBoard(const SnapshotRecord &record);
+        bool restore(const SnapshotRecord &record, Game &game);
+    }
+
+    // Appends snapshots to a file, many games per file. Opening a file drops a torn record left at its end
+    // by an interrupted append, and fails without touching the file if a record before that is corrupted.
+    class SnapshotWriter
+    {
+        std::FILE *m_file;
+        std::vector<uint8_t> m_buffer;
+
+    public:
+        SnapshotWriter();
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter &) = delete;
+        SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+        bool open(const std::string &path);
+        bool append(const Game &game);
+        bool flush();
+    };
+
+    // Maps a snapshot file and indexes its records without decoding them.
+    class SnapshotFile
+    {
+        const uint8_t *m_data;
+        size_t m_size;
+        std::vector<const SnapshotRecord *> m_records;
+
+        void close();
+
+    public:
+        SnapshotFile();
+        ~SnapshotFile();
+
+        SnapshotFile(const SnapshotFile &) = delete;
+        SnapshotFile &operator=(const SnapshotFile &) = delete;
+
+        // A truncated or foreign record ends the index, everything before it stays readable.
+        bool open(const std::string &path);
+
+        size_t size() const;
+        const SnapshotRecord &operator[](size_t index) const;
+        bool restore(size_t index, Game &game) const;
+    };
+}
+
+#endif
@@ -3,25 +3,41 @@
 namespace Chess
 {
 
-    bool Square::setPiece(std::shared_ptr<Piece> piece)
+    Square::Square()
+        : m_piece(0)
     {
-        m_piece = piece;
+    }
+
+    bool Square::setPiece(const Piece *piece)
+    {
+        m_piece = piece == nullptr ? 0 : piece->getCode();
+        return true;
+    }
+
+    const Piece *Square::getPiece() const
+    {
+        return Piece::fromCode(m_piece);
+    }
+
+    bool Square::setCode(uint8_t code)
+    {
+        m_piece = code;
         return true;
     }
 
-    std::shared_ptr<Piece> Square::getPiece()
+    uint8_t Square::getCode() const
     {
         return m_piece;
     }
 
-    char Square::getAsciiRepresentation()
+    char Square::getAsciiRepresentation() const
     {
-        if (m_piece == nullptr)
+        if (m_piece == 0)
         {
             return '.';
         }
 
-        return m_piece->getAsciiRepresentation();
+        return getPiece()->getAsciiRepresentation();
     }
 
-}
\ No newline at end of file
+}
@@ -3,19 +3,22 @@
 
 #include "pieces.h"
 
-#include <memory>
+#include <cstdint>
 
 namespace Chess
 {
     class Square
     {
-        std::shared_ptr<Piece> m_piece;
+        uint8_t m_piece; // flyweight code, see Piece::getCode()
 
     public:
-        bool setPiece(std::shared_ptr<Piece> piece);
-        std::shared_ptr<Piece> getPiece();
-        char getAsciiRepresentation();
+        Square();
+        bool setPiece(const Piece *piece);
+        const Piece *getPiece() const;
+        bool setCode(uint8_t code);
+        uint8_t getCode() const;
+        char getAsciiRepresentation() const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif